@@ -1,49 +1,182 @@
 #ifndef DELEGATES_H
 #define DELEGATES_H
 
+#include <QApplication>
+#include <QCache>
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDate>
 #include <QDateTimeEdit>
 #include <QDoubleSpinBox>
 #include <QLineEdit>
+#include <QPainter>
+#include <QPointer>
 #include <QProgressBar>
 #include <QRadioButton>
 #include <QSlider>
 #include <QSpinBox>
+#include <QStaticText>
 #include <QStyledItemDelegate>
 #include <QTextBrowser>
 #include <QTextEdit>
+#include "tableImport.h"
 #include "tableWidget_global.h"
 
-class TABLE_EXPORT DateTimeDelegate : public QStyledItemDelegate {
+// Parsed values of temporal cells and their display strings, keyed by the cell text,
+// so painting and editing never parse the same text twice. Cells that already hold a
+// native T, or carry one in ColumnTypes::ValueRole from a typed import, are used as
+// they are.
+template <typename T>
+class TemporalValueCache {
    public:
-    DateTimeDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+    using Parser = T (*)(const QString& text);
+
+    explicit TemporalValueCache(Parser parse, int size = 2048) : parse(parse), entries(size) {}
+
+    T value(const QVariant& data) const {
+        if (data.metaType() == QMetaType::fromType<T>())
+            return data.value<T>();
+
+        const QString text = data.toString();
+        return text.isEmpty() ? T() : entry(text)->value;
+    }
+
+    // The cell formatted with format, or a null string if it holds no valid value.
+    QString display(const QVariant& data, const QString& format) const {
+        if (data.metaType() == QMetaType::fromType<T>()) {
+            const T native = data.value<T>();
+            return native.isValid() ? native.toString(format) : QString();
+        }
+
+        const QString text = data.toString();
+        if (text.isEmpty())
+            return QString();
+
+        Entry* cached = entry(text);
+        if (cached->display.isNull() && cached->value.isValid())
+            cached->display = cached->value.toString(format);
+        return cached->display;
+    }
+
+    T value(const QModelIndex& index) const { return value(cellData(index)); }
+
+    QString display(const QModelIndex& index, const QString& format) const {
+        return display(cellData(index), format);
+    }
+
+    void clear() { entries.clear(); }
+
+   private:
+    static QVariant cellData(const QModelIndex& index) {
+        const QVariant typed = index.data(ColumnTypes::ValueRole);
+        return typed.metaType() == QMetaType::fromType<T>() ? typed : index.data();
+    }
+
+    struct Entry {
+        T value;
+        QString display;
+    };
+
+    Entry* entry(const QString& text) const {
+        if (Entry* cached = entries.object(text))
+            return cached;
+
+        Entry* parsed = new Entry{parse(text), QString()};
+        entries.insert(text, parsed);
+        return parsed;
+    }
+
+    Parser parse;
+    mutable QCache<QString, Entry> entries;
+};
+
+// Base for delegates whose editors are recycled. When the view closes an editor it
+// is hidden and kept, and the next edit in the same view reuses it; setEditorData
+// then loads the new cell. newEditor() should only do per-delegate setup (ranges,
+// combo box items, formats), since that is done once per pooled editor.
+class TABLE_EXPORT PooledItemDelegate : public QStyledItemDelegate {
+   public:
+    explicit PooledItemDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+
+    ~PooledItemDelegate() override {
+        for (const QPointer<QWidget>& editor : std::as_const(pool)) {
+            delete editor.data();
+        }
+    }
+
+    // Maximum number of idle editors kept. 0 disables pooling.
+    void setEditorPoolSize(int size) {
+        poolSize = qMax(0, size);
+        while (pool.size() > poolSize) {
+            delete pool.takeLast().data();
+        }
+    }
 
     QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
                           const QModelIndex& index) const override {
+        for (int i = pool.size() - 1; i >= 0; --i) {
+            QWidget* editor = pool[i];
+            if (!editor) {
+                // Deleted along with its parent
+                pool.removeAt(i);
+            } else if (editor->parentWidget() == parent) {
+                pool.removeAt(i);
+                return editor;
+            }
+        }
+        return newEditor(parent, option, index);
+    }
+
+    void destroyEditor(QWidget* editor, const QModelIndex& index) const override {
+        if (pool.size() >= poolSize) {
+            QStyledItemDelegate::destroyEditor(editor, index);
+            return;
+        }
+        editor->hide();
+        pool.append(editor);
+    }
+
+   protected:
+    virtual QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                               const QModelIndex& index) const = 0;
+
+   private:
+    int poolSize = 4;
+    mutable QList<QPointer<QWidget>> pool;
+};
+
+class TABLE_EXPORT DateTimeDelegate : public PooledItemDelegate {
+   public:
+    DateTimeDelegate(QObject* parent = nullptr) : PooledItemDelegate(parent) {}
+
+    // Format used to show cells, e.g. "dd MMM yyyy hh:mm". Empty (the default) shows
+    // the stored text. Cells that do not parse are always shown as stored.
+    void setDisplayFormat(const QString& format) {
+        displayFormat = format;
+        cache.clear();
+    }
+
+    void initStyleOption(QStyleOptionViewItem* option, const QModelIndex& index) const override {
+        PooledItemDelegate::initStyleOption(option, index);
+        const QString text = displayFormat.isEmpty() ? QString() : cache.display(index, displayFormat);
+        if (!text.isNull())
+            option->text = text;
+    }
+
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QDateTimeEdit* editor = new QDateTimeEdit(parent);
         editor->setMinimumWidth(200);
 
         editor->setDisplayFormat("yyyy-MM-dd hh:mm:ss AP");
         editor->setCalendarPopup(true);
-
-        QString dateTimeStr = index.data().toString();
-        if (!dateTimeStr.isEmpty()) {
-            QDateTime dateTime = QDateTime::fromString(dateTimeStr, Qt::ISODate);
-            editor->setDateTime(dateTime);
-        } else {
-            editor->clear();
-        }
-
         return editor;
     }
 
     void setEditorData(QWidget* editor, const QModelIndex& index) const override {
         QDateTimeEdit* dateTimeEditor = static_cast<QDateTimeEdit*>(editor);
-        QString dateTimeStr = index.data().toString();
-        if (!dateTimeStr.isEmpty()) {
-            QDateTime dateTime = QDateTime::fromString(dateTimeStr, Qt::ISODate);
+        const QDateTime dateTime = cache.value(index);
+        if (dateTime.isValid()) {
             dateTimeEditor->setDateTime(dateTime);
         } else {
             dateTimeEditor->clear();
@@ -56,19 +189,41 @@ class TABLE_EXPORT DateTimeDelegate : public QStyledItemDelegate {
         QString dateTimeStr = dateTimeEditor->dateTime().toString(Qt::ISODate);
         model->setData(index, dateTimeStr);
     }
+
+   private:
+    static QDateTime parse(const QString& text) {
+        return QDateTime::fromString(text, Qt::ISODate);
+    }
+
+    QString displayFormat;
+    TemporalValueCache<QDateTime> cache{parse};
 };
 
-class TABLE_EXPORT DateDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT DateDelegate : public PooledItemDelegate {
    public:
     DateDelegate(QObject* parent = nullptr, QDate defaultDate = QDate::currentDate(),
                  QDate minDate = QDate(), QDate maxDate = QDate())
-        : QStyledItemDelegate(parent),
+        : PooledItemDelegate(parent),
           defaultDate(defaultDate),
           minDate(minDate),
           maxDate(maxDate) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    // Format used to show cells, e.g. "dd/MM/yyyy". Empty (the default) shows the
+    // stored text. Cells that do not parse are always shown as stored.
+    void setDisplayFormat(const QString& format) {
+        displayFormat = format;
+        cache.clear();
+    }
+
+    void initStyleOption(QStyleOptionViewItem* option, const QModelIndex& index) const override {
+        PooledItemDelegate::initStyleOption(option, index);
+        const QString text = displayFormat.isEmpty() ? QString() : cache.display(index, displayFormat);
+        if (!text.isNull())
+            option->text = text;
+    }
+
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QDateEdit* editor = new QDateEdit(parent);
 
         // If minDate is set
@@ -86,13 +241,13 @@ class TABLE_EXPORT DateDelegate : public QStyledItemDelegate {
 
         editor->setDisplayFormat("yyyy-MM-dd");
         editor->setCalendarPopup(true);
-        editor->setDateTime(QDateTime::fromString(index.data().toString(), "yyyy-MM-dd"));
         return editor;
     }
 
     void setEditorData(QWidget* editor, const QModelIndex& index) const override {
         QDateTimeEdit* dateEditor = static_cast<QDateTimeEdit*>(editor);
-        dateEditor->setDateTime(QDateTime::fromString(index.data().toString(), "yyyy-MM-dd"));
+        const QDate date = cache.value(index);
+        dateEditor->setDate(date.isValid() ? date : defaultDate);
     }
 
     void setModelData(QWidget* editor, QAbstractItemModel* model,
@@ -103,34 +258,45 @@ class TABLE_EXPORT DateDelegate : public QStyledItemDelegate {
     }
 
    private:
+    static QDate parse(const QString& text) {
+        return QDate::fromString(text, "yyyy-MM-dd");
+    }
+
     QDate minDate, maxDate, defaultDate;
+    QString displayFormat;
+    TemporalValueCache<QDate> cache{parse};
 };
 
-class TABLE_EXPORT TimeDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT TimeDelegate : public PooledItemDelegate {
    public:
-    TimeDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+    TimeDelegate(QObject* parent = nullptr) : PooledItemDelegate(parent) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    // Format used to show cells, e.g. "h:mm AP". Empty (the default) shows the stored
+    // text. Cells that do not parse are always shown as stored.
+    void setDisplayFormat(const QString& format) {
+        displayFormat = format;
+        cache.clear();
+    }
+
+    void initStyleOption(QStyleOptionViewItem* option, const QModelIndex& index) const override {
+        PooledItemDelegate::initStyleOption(option, index);
+        const QString text = displayFormat.isEmpty() ? QString() : cache.display(index, displayFormat);
+        if (!text.isNull())
+            option->text = text;
+    }
+
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QTimeEdit* editor = new QTimeEdit(parent);
         editor->setMinimumWidth(120);
         editor->setDisplayFormat("hh:mm:ss AP");
-
-        QString timeStr = index.data().toString();
-        if (!timeStr.isEmpty() && timeStr != "null") {
-            QTime time = QTime::fromString(timeStr, Qt::ISODate);
-            editor->setTime(time);
-        } else {
-            editor->clear();
-        }
         return editor;
     }
 
     void setEditorData(QWidget* editor, const QModelIndex& index) const override {
         QTimeEdit* timeEditor = static_cast<QTimeEdit*>(editor);
-        QString timeStr = index.data().toString();
-        if (!timeStr.isEmpty() && timeStr != "null") {
-            QTime time = QTime::fromString(timeStr, Qt::ISODate);
+        const QTime time = cache.value(index);
+        if (time.isValid()) {
             timeEditor->setTime(time);
         } else {
             timeEditor->clear();
@@ -143,20 +309,28 @@ class TABLE_EXPORT TimeDelegate : public QStyledItemDelegate {
         QString timeStr = timeEditor->time().toString(Qt::ISODate);
         model->setData(index, timeStr);
     }
+
+   private:
+    // "null" is what empty times look like in some exported data
+    static QTime parse(const QString& text) {
+        return text == "null" ? QTime() : QTime::fromString(text, Qt::ISODate);
+    }
+
+    QString displayFormat;
+    TemporalValueCache<QTime> cache{parse};
 };
 
-class TABLE_EXPORT SpinBoxDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT SpinBoxDelegate : public PooledItemDelegate {
    public:
     SpinBoxDelegate(QObject* parent = nullptr, int min = 0, int max = 100)
-        : QStyledItemDelegate(parent), min(min), max(max) {}
+        : PooledItemDelegate(parent), min(min), max(max) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QSpinBox* editor = new QSpinBox(parent);
 
         editor->setMinimum(min);
         editor->setMaximum(max);
-        editor->setValue(index.data().toInt());
         return editor;
     }
 
@@ -175,15 +349,13 @@ class TABLE_EXPORT SpinBoxDelegate : public QStyledItemDelegate {
     int min, max;
 };
 
-class TABLE_EXPORT TextEditDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT TextEditDelegate : public PooledItemDelegate {
    public:
-    TextEditDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+    TextEditDelegate(QObject* parent = nullptr) : PooledItemDelegate(parent) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QTextEdit* editor = new QTextEdit(parent);
-
-        editor->setPlainText(index.data().toString());
         return editor;
     }
 
@@ -199,15 +371,13 @@ class TABLE_EXPORT TextEditDelegate : public QStyledItemDelegate {
     }
 };
 
-class TABLE_EXPORT TextBrowserDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT TextBrowserDelegate : public PooledItemDelegate {
    public:
-    TextBrowserDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+    TextBrowserDelegate(QObject* parent = nullptr) : PooledItemDelegate(parent) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QTextBrowser* editor = new QTextBrowser(parent);
-
-        editor->setHtml(index.data().toString());
         return editor;
     }
 
@@ -223,15 +393,13 @@ class TABLE_EXPORT TextBrowserDelegate : public QStyledItemDelegate {
     }
 };
 
-class TABLE_EXPORT LineEditDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT LineEditDelegate : public PooledItemDelegate {
    public:
-    LineEditDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+    LineEditDelegate(QObject* parent = nullptr) : PooledItemDelegate(parent) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QLineEdit* editor = new QLineEdit(parent);
-
-        editor->setText(index.data().toString());
         return editor;
     }
 
@@ -247,17 +415,16 @@ class TABLE_EXPORT LineEditDelegate : public QStyledItemDelegate {
     }
 };
 
-class TABLE_EXPORT ComboBoxDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT ComboBoxDelegate : public PooledItemDelegate {
    public:
     ComboBoxDelegate(QObject* parent = nullptr, const QStringList& items = QStringList())
-        : QStyledItemDelegate(parent), items(items) {}
+        : PooledItemDelegate(parent), items(items) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QComboBox* editor = new QComboBox(parent);
 
         editor->addItems(items);
-        editor->setCurrentText(index.data().toString());
         return editor;
     }
 
@@ -276,15 +443,13 @@ class TABLE_EXPORT ComboBoxDelegate : public QStyledItemDelegate {
     QStringList items;
 };
 
-class TABLE_EXPORT RadioButtonDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT RadioButtonDelegate : public PooledItemDelegate {
    public:
-    RadioButtonDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+    RadioButtonDelegate(QObject* parent = nullptr) : PooledItemDelegate(parent) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QRadioButton* editor = new QRadioButton(parent);
-
-        editor->setChecked(index.data().toBool());
         return editor;
     }
 
@@ -299,15 +464,13 @@ class TABLE_EXPORT RadioButtonDelegate : public QStyledItemDelegate {
     }
 };
 
-class TABLE_EXPORT CheckBoxDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT CheckBoxDelegate : public PooledItemDelegate {
    public:
-    CheckBoxDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+    CheckBoxDelegate(QObject* parent = nullptr) : PooledItemDelegate(parent) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QCheckBox* editor = new QCheckBox(parent);
-
-        editor->setChecked(index.data().toBool());
         return editor;
     }
 
@@ -323,16 +486,15 @@ class TABLE_EXPORT CheckBoxDelegate : public QStyledItemDelegate {
     }
 };
 
-class TABLE_EXPORT DoubleSpinBoxDelegate : public QStyledItemDelegate {
+class TABLE_EXPORT DoubleSpinBoxDelegate : public PooledItemDelegate {
    public:
     DoubleSpinBoxDelegate(QObject* parent = nullptr, int decimals = 2, int min = 0, int max = 100)
-        : QStyledItemDelegate(parent), decimals(decimals), min(min), max(max) {}
+        : PooledItemDelegate(parent), decimals(decimals), min(min), max(max) {}
 
-    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option,
-                          const QModelIndex& index) const override {
+    QWidget* newEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override {
         QDoubleSpinBox* editor = new QDoubleSpinBox(parent);
 
-        editor->setValue(index.data().toDouble());
         editor->setDecimals(decimals);
         editor->setMaximum(max);
         editor->setMinimum(min);
@@ -354,4 +516,114 @@ class TABLE_EXPORT DoubleSpinBoxDelegate : public QStyledItemDelegate {
     int decimals, max, min;
 };
 
+// Display-only delegate for large read-mostly tables. Single-line text is elided and
+// laid out once per (text, font, width), kept as QStaticText in an LRU cache, and
+// drawn directly, so repaints while scrolling skip text shaping. Cells with icons,
+// check boxes or line breaks are drawn by QStyledItemDelegate as usual.
+// Install with setItemDelegate() or setItemDelegateForColumn().
+class TABLE_EXPORT FastTextDelegate : public QStyledItemDelegate {
+   public:
+    FastTextDelegate(QObject* parent = nullptr, int cacheSize = 4096)
+        : QStyledItemDelegate(parent), textCache(qMax(1, cacheSize)) {}
+
+    // Maximum number of laid-out strings kept
+    void setCacheSize(int entries) { textCache.setMaxCost(qMax(1, entries)); }
+
+    void clearCache() { textCache.clear(); }
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override {
+        QStyleOptionViewItem opt = option;
+        initStyleOption(&opt, index);
+
+        if (opt.features & (QStyleOptionViewItem::HasDecoration | QStyleOptionViewItem::HasCheckIndicator) ||
+            opt.text.contains(QLatin1Char('\n'))) {
+            QStyledItemDelegate::paint(painter, option, index);
+            return;
+        }
+
+        const QWidget* widget = opt.widget;
+        QStyle* style = widget ? widget->style() : QApplication::style();
+        style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, painter, widget);
+
+        // Same text margins as QCommonStyle, without its full item layout pass
+        const int margin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, nullptr, widget) + 1;
+        const QRect textRect = opt.rect.adjusted(margin, 0, -margin, 0);
+
+        if (!opt.text.isEmpty() && textRect.width() > 0) {
+            const QStaticText* text = layoutText(opt.text, opt.font, textRect.width(), opt.textElideMode);
+            const QSizeF size = text->size();
+
+            qreal x = textRect.left();
+            if (opt.displayAlignment & Qt::AlignRight)
+                x = textRect.right() + 1 - size.width();
+            else if (opt.displayAlignment & Qt::AlignHCenter)
+                x = textRect.left() + (textRect.width() - size.width()) / 2;
+            const qreal y = textRect.top() + (textRect.height() - size.height()) / 2;
+
+            const QPalette::ColorGroup group = !(opt.state & QStyle::State_Enabled) ? QPalette::Disabled
+                                               : (opt.state & QStyle::State_Active) ? QPalette::Normal
+                                                                                     : QPalette::Inactive;
+            const bool selected = opt.state & QStyle::State_Selected;
+
+            painter->save();
+            painter->setClipRect(textRect);
+            painter->setFont(opt.font);
+            painter->setPen(opt.palette.color(group, selected ? QPalette::HighlightedText : QPalette::Text));
+            painter->drawStaticText(QPointF(x, y), *text);
+            painter->restore();
+        }
+
+        if (opt.state & QStyle::State_HasFocus) {
+            QStyleOptionFocusRect focus;
+            focus.QStyleOption::operator=(opt);
+            focus.state |= QStyle::State_KeyboardFocusChange;
+            focus.backgroundColor = opt.palette.color(
+                (opt.state & QStyle::State_Selected) ? QPalette::Highlight : QPalette::Window);
+            style->drawPrimitive(QStyle::PE_FrameFocusRect, &focus, painter, widget);
+        }
+    }
+
+   private:
+    struct LayoutKey {
+        QString text;
+        QString font;
+        int width;
+        int elideMode;
+
+        bool operator==(const LayoutKey& other) const {
+            return width == other.width && elideMode == other.elideMode && text == other.text &&
+                   font == other.font;
+        }
+    };
+
+    friend size_t qHash(const LayoutKey& key, size_t seed = 0) {
+        return qHashMulti(seed, key.text, key.font, key.width, key.elideMode);
+    }
+
+    const QStaticText* layoutText(const QString& text, const QFont& font, int width,
+                                  Qt::TextElideMode elideMode) const {
+        // QFont::key() builds a string, so remember it for the font in use.
+        if (font != lastFont || lastFontKey.isEmpty()) {
+            lastFont = font;
+            lastFontKey = font.key();
+        }
+
+        const LayoutKey key{text, lastFontKey, width, int(elideMode)};
+        if (QStaticText* cached = textCache.object(key))
+            return cached;
+
+        QStaticText* laidOut = new QStaticText(QFontMetrics(font).elidedText(text, elideMode, width));
+        laidOut->setTextFormat(Qt::PlainText);
+        laidOut->setPerformanceHint(QStaticText::AggressiveCaching);
+        laidOut->prepare(QTransform(), font);
+        textCache.insert(key, laidOut);
+        return laidOut;
+    }
+
+    mutable QCache<LayoutKey, QStaticText> textCache;
+    mutable QFont lastFont;
+    mutable QString lastFontKey;
+};
+
 #endif  // DELEGATES_H
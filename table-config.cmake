@@ -2,6 +2,6 @@ get_filename_component(SELF_DIR ${CMAKE_CURRENT_LIST_DIR} PATH)
 
 include(CMakeFindDependencyMacro)
 
-find_dependency(Qt6 REQUIRED COMPONENTS Core Widgets)
+find_dependency(Qt6 REQUIRED COMPONENTS Core Widgets Concurrent)
 
 include(${SELF_DIR}/table/table.cmake)
@@ -0,0 +1,353 @@
+#ifndef TABLE_BINARY_H
+#define TABLE_BINARY_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include "tableWidget_global.h"
+
+// Native columnar table file used by TableWidget::saveSnapshot/loadSnapshot.
+//
+// All integers are little endian. Layout:
+//   "QTWT" u32 version, u32 flags, u32 columnCount, u64 rowCount
+//   per column: u32 length + UTF-8 header, u32 length + UTF-8 field name
+//   u64 columnOffset[columnCount]  (absolute file offsets of the column blocks)
+//   column block: u8 encoding, u8[3] reserved, u32 checksum, u64 payloadSize, payload
+//
+// Dictionary payload: u32 dictCount, u32 reserved, u64 dictOffsets[dictCount + 1],
+//                     u32 codes[rowCount], dictionary bytes
+// Plain payload:      u64 offsets[rowCount + 1], cell bytes
+//
+// Offsets point into the trailing byte area of the block, so every cell can be read
+// straight from the mapped file without scanning anything before it.
+namespace BinaryTable {
+constexpr char Magic[4] = {'Q', 'T', 'W', 'T'};
+constexpr quint32 Version = 1;
+constexpr quint32 ChecksumFlag = 0x1;
+constexpr int BlockHeaderSize = 16;
+
+enum Encoding : quint8 { Dictionary = 0, Plain = 1 };
+}  // namespace BinaryTable
+
+class TABLE_EXPORT BinaryTableWriter {
+   public:
+    using CellReader = std::function<QString(int row, int col)>;
+
+    // Writes rowCount x columnCount cells to path. Columns whose distinct values are
+    // at most half the row count are dictionary encoded.
+    static bool write(const QString& path, const QStringList& headers, const QStringList& fieldNames,
+                      int rowCount, int columnCount, const CellReader& cell, bool checksums = true,
+                      QString* errorString = nullptr) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            if (errorString)
+                *errorString = file.errorString();
+            return false;
+        }
+
+        QByteArray header;
+        header.append(BinaryTable::Magic, 4);
+        put<quint32>(header, BinaryTable::Version);
+        put<quint32>(header, checksums ? BinaryTable::ChecksumFlag : 0);
+        put<quint32>(header, quint32(columnCount));
+        put<quint64>(header, quint64(rowCount));
+        for (int col = 0; col < columnCount; ++col) {
+            putString(header, headers.value(col));
+            putString(header, fieldNames.value(col));
+        }
+
+        // Reserve the offset table; it is filled in once the blocks are written.
+        const qint64 offsetTablePos = header.size();
+        header.append(QByteArray(columnCount * int(sizeof(quint64)), '\0'));
+
+        QVector<quint64> columnOffsets(columnCount);
+        bool ok = file.write(header) == header.size();
+
+        for (int col = 0; ok && col < columnCount; ++col) {
+            columnOffsets[col] = quint64(file.pos());
+            const QByteArray block = encodeColumn(col, rowCount, cell, checksums);
+            ok = file.write(block) == block.size();
+        }
+
+        if (ok) {
+            QByteArray offsets;
+            for (quint64 offset : columnOffsets) {
+                put<quint64>(offsets, offset);
+            }
+            ok = file.seek(offsetTablePos) && file.write(offsets) == offsets.size();
+        }
+
+        if (!ok && errorString)
+            *errorString = file.errorString();
+        return ok;
+    }
+
+   private:
+    template <typename T>
+    static void put(QByteArray& out, T value) {
+        const T le = qToLittleEndian(value);
+        out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+    }
+
+    static void putString(QByteArray& out, const QString& value) {
+        const QByteArray utf8 = value.toUtf8();
+        put<quint32>(out, quint32(utf8.size()));
+        out.append(utf8);
+    }
+
+    static QByteArray encodeColumn(int col, int rowCount, const CellReader& cell, bool checksums) {
+        QStringList values;
+        values.reserve(rowCount);
+
+        QHash<QString, quint32> codeOf;
+        QStringList dictionary;
+        bool useDictionary = true;
+
+        for (int row = 0; row < rowCount; ++row) {
+            values.append(cell(row, col));
+            if (useDictionary && !codeOf.contains(values.last())) {
+                codeOf.insert(values.last(), quint32(dictionary.size()));
+                dictionary.append(values.last());
+                useDictionary = dictionary.size() <= rowCount / 2 + 1;
+            }
+        }
+
+        QByteArray payload;
+        QByteArray bytes;
+        if (useDictionary) {
+            put<quint32>(payload, quint32(dictionary.size()));
+            put<quint32>(payload, 0);
+            put<quint64>(payload, 0);
+            for (const QString& value : dictionary) {
+                bytes.append(value.toUtf8());
+                put<quint64>(payload, quint64(bytes.size()));
+            }
+            for (const QString& value : values) {
+                put<quint32>(payload, codeOf.value(value));
+            }
+        } else {
+            put<quint64>(payload, 0);
+            for (const QString& value : values) {
+                bytes.append(value.toUtf8());
+                put<quint64>(payload, quint64(bytes.size()));
+            }
+        }
+        payload.append(bytes);
+
+        QByteArray block;
+        block.reserve(BinaryTable::BlockHeaderSize + payload.size());
+        block.append(char(useDictionary ? BinaryTable::Dictionary : BinaryTable::Plain));
+        block.append(3, '\0');
+        put<quint32>(block, checksums ? qChecksum(payload) : 0);
+        put<quint64>(block, quint64(payload.size()));
+        block.append(payload);
+        return block;
+    }
+};
+
+// Reads a file written by BinaryTableWriter through a memory mapping.
+// Cells are decoded on access; nothing is parsed up front besides the header.
+class TABLE_EXPORT BinaryTableReader {
+   public:
+    BinaryTableReader() = default;
+    BinaryTableReader(const BinaryTableReader&) = delete;
+    BinaryTableReader& operator=(const BinaryTableReader&) = delete;
+
+    bool open(const QString& path) {
+        file.setFileName(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return fail(file.errorString());
+
+        size = file.size();
+        data = file.map(0, size);
+        if (!data)
+            return fail(file.errorString());
+
+        if (size < 24 || memcmp(data, BinaryTable::Magic, 4) != 0)
+            return fail("Not a table snapshot file");
+        if (get<quint32>(4) != BinaryTable::Version)
+            return fail("Unsupported table snapshot version");
+
+        flags = get<quint32>(8);
+        const quint32 columnCount = get<quint32>(12);
+        const quint64 rowCount = get<quint64>(16);
+        if (rowCount > quint64(std::numeric_limits<int>::max()))
+            return fail("Too many rows");
+        rows = int(rowCount);
+
+        qint64 pos = 24;
+        for (quint32 col = 0; col < columnCount; ++col) {
+            QString header, fieldName;
+            if (!readString(pos, header) || !readString(pos, fieldName))
+                return fail("Truncated table snapshot header");
+            headerList.append(header);
+            fieldList.append(fieldName);
+        }
+
+        // Tables saved without field names store empty strings.
+        if (std::all_of(fieldList.cbegin(), fieldList.cend(), [](const QString& name) { return name.isEmpty(); }))
+            fieldList.clear();
+
+        if (pos + qint64(columnCount) * 8 > size)
+            return fail("Truncated column table");
+
+        for (quint32 col = 0; col < columnCount; ++col) {
+            Column column;
+            if (!readColumn(get<quint64>(pos + col * 8), column))
+                return fail(QString("Corrupt column block %1").arg(col));
+            columnList.append(column);
+        }
+        return true;
+    }
+
+    QString errorString() const { return error; }
+    int rowCount() const { return rows; }
+    int columnCount() const { return columnList.size(); }
+    QStringList headers() const { return headerList; }
+    QStringList fieldNames() const { return fieldList; }
+    bool hasChecksums() const { return flags & BinaryTable::ChecksumFlag; }
+
+    // Decodes a single cell from the mapped file.
+    QString cell(int row, int col) const {
+        const Column& column = columnList[col];
+        if (column.encoding == BinaryTable::Dictionary) {
+            const quint32 code = qFromLittleEndian<quint32>(column.codes + qint64(row) * 4);
+            return code < column.dictCount ? text(column, column.dictOffsets, code) : QString();
+        }
+        return text(column, column.offsets, row);
+    }
+
+    // Calls fn(row, text) for every cell of a column. Dictionary entries are decoded
+    // once and shared between all rows that use them.
+    template <typename Fn>
+    void forEachCell(int col, Fn&& fn) const {
+        const Column& column = columnList[col];
+        if (column.encoding == BinaryTable::Dictionary) {
+            QStringList dictionary;
+            dictionary.reserve(column.dictCount);
+            for (quint32 code = 0; code < column.dictCount; ++code) {
+                dictionary.append(text(column, column.dictOffsets, code));
+            }
+            for (int row = 0; row < rows; ++row) {
+                const quint32 code = qFromLittleEndian<quint32>(column.codes + qint64(row) * 4);
+                fn(row, code < column.dictCount ? dictionary[code] : QString());
+            }
+        } else {
+            for (int row = 0; row < rows; ++row) {
+                fn(row, text(column, column.offsets, row));
+            }
+        }
+    }
+
+    // Recomputes the block checksums. Returns true if the file has none.
+    bool verifyChecksums() const {
+        if (!hasChecksums())
+            return true;
+
+        for (const Column& column : columnList) {
+            QByteArrayView payload(column.payload, column.payloadSize);
+            if (qChecksum(payload) != column.checksum)
+                return false;
+        }
+        return true;
+    }
+
+   private:
+    struct Column {
+        quint8 encoding = BinaryTable::Plain;
+        quint32 checksum = 0;
+        const uchar* payload = nullptr;
+        qint64 payloadSize = 0;
+        quint32 dictCount = 0;
+        const uchar* dictOffsets = nullptr;
+        const uchar* codes = nullptr;
+        const uchar* offsets = nullptr;
+        const uchar* bytes = nullptr;
+        qint64 bytesSize = 0;
+    };
+
+    template <typename T>
+    T get(qint64 pos) const {
+        return qFromLittleEndian<T>(data + pos);
+    }
+
+    bool fail(const QString& message) {
+        error = message;
+        return false;
+    }
+
+    bool readString(qint64& pos, QString& value) const {
+        if (pos < 0 || pos > size || size - pos < 4)
+            return false;
+        const quint32 length = get<quint32>(pos);
+        pos += 4;
+        if (size - pos < qint64(length))
+            return false;
+        value = QString::fromUtf8(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return true;
+    }
+
+    bool readColumn(quint64 offset, Column& column) const {
+        // Subtract from the file size rather than add to untrusted values, which can wrap.
+        if (offset > quint64(size) || quint64(size) - offset < quint64(BinaryTable::BlockHeaderSize))
+            return false;
+
+        const quint64 payloadSize = get<quint64>(offset + 8);
+        if (payloadSize > quint64(size) - offset - BinaryTable::BlockHeaderSize)
+            return false;
+
+        column.encoding = data[offset];
+        column.checksum = get<quint32>(offset + 4);
+        column.payloadSize = qint64(payloadSize);
+        column.payload = data + offset + BinaryTable::BlockHeaderSize;
+
+        qint64 indexSize = 0;
+        if (column.encoding == BinaryTable::Dictionary) {
+            if (column.payloadSize < 8)
+                return false;
+            column.dictCount = qFromLittleEndian<quint32>(column.payload);
+            column.dictOffsets = column.payload + 8;
+            column.codes = column.dictOffsets + (qint64(column.dictCount) + 1) * 8;
+            indexSize = 8 + (qint64(column.dictCount) + 1) * 8 + qint64(rows) * 4;
+        } else if (column.encoding == BinaryTable::Plain) {
+            column.offsets = column.payload;
+            indexSize = (qint64(rows) + 1) * 8;
+        } else {
+            return false;
+        }
+
+        if (indexSize > column.payloadSize)
+            return false;
+        column.bytes = column.payload + indexSize;
+        column.bytesSize = column.payloadSize - indexSize;
+        return true;
+    }
+
+    static QString text(const Column& column, const uchar* offsets, qint64 i) {
+        const quint64 begin = qFromLittleEndian<quint64>(offsets + i * 8);
+        const quint64 end = qFromLittleEndian<quint64>(offsets + (i + 1) * 8);
+        if (begin > end || end > quint64(column.bytesSize))
+            return QString();
+        return QString::fromUtf8(reinterpret_cast<const char*>(column.bytes + begin), qsizetype(end - begin));
+    }
+
+    QFile file;
+    const uchar* data = nullptr;
+    qint64 size = 0;
+    quint32 flags = 0;
+    int rows = 0;
+    QStringList headerList;
+    QStringList fieldList;
+    QVector<Column> columnList;
+    QString error;
+};
+
+#endif  // TABLE_BINARY_H
@@ -0,0 +1,206 @@
+#ifndef TABLE_EXPORT_H
+#define TABLE_EXPORT_H
+
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <functional>
+#include "tableWidget_global.h"
+
+// Output formats understood by TableExporter and TableWidget::exportAsync.
+enum class ExportFormat { Csv, Json, Html };
+
+// A consistent copy of the table contents in view order.
+// Cell text is implicitly shared with the model, so taking a snapshot only
+// allocates the row lists; it can then be handed to a worker thread.
+struct TABLE_EXPORT TableSnapshot {
+    QStringList headers;
+    QStringList fieldNames;  // Empty unless field names match the headers.
+    QVector<QStringList> rows;
+    int columns = 0;
+
+    int rowCount() const { return rows.size(); }
+    int columnCount() const { return columns; }
+
+    // Key used for a column in CSV headers and JSON objects.
+    QString columnKey(int col) const {
+        return fieldNames.isEmpty() ? headers.value(col) : fieldNames.value(col);
+    }
+};
+
+// Streams an HTML table to a QIODevice.
+// Styling is emitted once as a stylesheet; cells carry no inline styles and all
+// text is escaped. Rows can be written in as many chunks as needed between
+// beginTable() and endTable().
+class TABLE_EXPORT HtmlTableWriter {
+   public:
+    explicit HtmlTableWriter(QIODevice* device) : out(device) {}
+
+    static QString styleSheet() {
+        return "table.tw { border-collapse: collapse; width: 100%; }"
+               " .tw th, .tw td { border: 1px solid #ddd; padding: 8px; }"
+               " .tw th { background-color: #f2f2f2; }";
+    }
+
+    void writeStyleSheet() {
+        out << "<style>" << styleSheet() << "</style>";
+    }
+
+    void beginTable(const QStringList& headers) {
+        out << "<table class='tw'><thead><tr>";
+        for (const QString& header : headers) {
+            out << "<th>" << header.toHtmlEscaped() << "</th>";
+        }
+        out << "</tr></thead><tbody>";
+    }
+
+    void writeRow(const QStringList& values) {
+        out << "<tr>";
+        for (const QString& value : values) {
+            out << "<td>" << value.toHtmlEscaped() << "</td>";
+        }
+        out << "</tr>\n";
+    }
+
+    void endTable() {
+        out << "</tbody></table>";
+        out.flush();
+    }
+
+    bool ok() const { return out.status() == QTextStream::Ok; }
+
+   private:
+    QTextStream out;
+};
+
+// Writes a TableSnapshot to a QIODevice. Used for background exports, so it
+// never touches the model or any widget.
+class TABLE_EXPORT TableExporter {
+   public:
+    // Called after each row with the number of rows written so far.
+    // Returning false aborts the export.
+    using Progress = std::function<bool(int rowsDone)>;
+    using ValueConverter = QVariant (*)(int col, const QString& cellData);
+
+    static bool write(ExportFormat format, const TableSnapshot& data, QIODevice* device,
+                      const Progress& progress = Progress(), ValueConverter valueConverter = nullptr) {
+        switch (format) {
+            case ExportFormat::Csv:
+                return writeCsv(data, device, progress);
+            case ExportFormat::Json:
+                return writeJson(data, device, progress, valueConverter);
+            case ExportFormat::Html:
+                return writeHtml(data, device, progress);
+        }
+        return false;
+    }
+
+    static bool writeCsv(const TableSnapshot& data, QIODevice* device,
+                         const Progress& progress = Progress()) {
+        QTextStream out(device);
+
+        if (!data.fieldNames.isEmpty()) {
+            for (int col = 0; col < data.columnCount(); ++col) {
+                if (col > 0) {
+                    out << ',';
+                }
+                out << '"' << data.fieldNames[col] << '"';
+            }
+            out << '\n';
+        }
+
+        for (int row = 0; row < data.rowCount(); ++row) {
+            const QStringList& values = data.rows[row];
+            for (int col = 0; col < values.size(); ++col) {
+                if (col > 0) {
+                    out << ',';
+                }
+                out << csvField(values[col]);
+            }
+            out << '\n';
+
+            if (!reportProgress(progress, row + 1))
+                return false;
+        }
+
+        out.flush();
+        return out.status() == QTextStream::Ok;
+    }
+
+    static bool writeJson(const TableSnapshot& data, QIODevice* device,
+                          const Progress& progress = Progress(), ValueConverter valueConverter = nullptr) {
+        QTextStream out(device);
+        out << "[\n";
+
+        for (int row = 0; row < data.rowCount(); ++row) {
+            const QStringList& values = data.rows[row];
+
+            QJsonObject rowObject;
+            for (int col = 0; col < values.size(); ++col) {
+                QVariant cellValue = values[col];
+                if (valueConverter) {
+                    cellValue = valueConverter(col, values[col]);
+                }
+                rowObject[data.columnKey(col)] = QJsonValue::fromVariant(cellValue);
+            }
+
+            if (row > 0) {
+                out << ",\n";
+            }
+            out << QString::fromUtf8(QJsonDocument(rowObject).toJson(QJsonDocument::Compact));
+
+            if (!reportProgress(progress, row + 1))
+                return false;
+        }
+
+        out << "\n]\n";
+        out.flush();
+        return out.status() == QTextStream::Ok;
+    }
+
+    static bool writeHtml(const TableSnapshot& data, QIODevice* device,
+                          const Progress& progress = Progress()) {
+        HtmlTableWriter writer(device);
+        writer.writeStyleSheet();
+        writer.beginTable(data.headers);
+
+        for (int row = 0; row < data.rowCount(); ++row) {
+            writer.writeRow(data.rows[row]);
+
+            if (!reportProgress(progress, row + 1))
+                return false;
+        }
+
+        writer.endTable();
+        return writer.ok();
+    }
+
+    // Quotes a CSV field if it contains a delimiter, quote or line break.
+    static QString csvField(const QString& value) {
+        bool needsQuotes = false;
+        for (QChar c : value) {
+            if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+                needsQuotes = true;
+                break;
+            }
+        }
+
+        if (!needsQuotes)
+            return value;
+
+        QString quoted = value;
+        quoted.replace("\"", "\"\"");
+        return "\"" + quoted + "\"";
+    }
+
+   private:
+    static bool reportProgress(const Progress& progress, int rowsDone) {
+        return !progress || progress(rowsDone);
+    }
+};
+
+#endif  // TABLE_EXPORT_H
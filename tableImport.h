@@ -0,0 +1,781 @@
+#ifndef TABLE_IMPORT_H
+#define TABLE_IMPORT_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVariant>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtAlgorithms>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+#include "tableWidget_global.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TABLE_IMPORT_SSE2
+#endif
+
+// CSV syntax understood by TableWidget::loadCsv.
+struct TABLE_EXPORT CsvDialect {
+    char delimiter = ',';
+    char quote = '"';
+    bool hasHeader = true;  // First record holds the field names, as written by generateCsvData.
+    // Also store numbers, booleans and ISO dates/times as typed values in
+    // ColumnTypes::ValueRole. Cell text is kept as read either way.
+    bool inferTypes = false;
+};
+
+// Value types detected per column by the importers.
+enum class ColumnType { Text, Integer, Double, Bool, Date, DateTime, Time };
+
+namespace ColumnTypes {
+// Item data role holding the typed value of an imported cell. The display and edit
+// roles keep the original text, so exports and editors see the data unchanged.
+// It sits well above Qt::UserRole so applications can keep using the roles just
+// above Qt::UserRole for their own data.
+constexpr int ValueRole = Qt::UserRole + 0x1000;
+
+// Empty cells and the literal "null" do not count against any type.
+inline bool isNull(const QString& text) {
+    return text.isEmpty() || text == QLatin1String("null");
+}
+
+// Converts text to a value of the given type. Returns an invalid QVariant if it does not parse.
+// Parsing is lenient ("+5", "10.50", "TRUE"); the cell keeps its text, so nothing is lost.
+// Dates use the formats the editors expect: "yyyy-MM-dd" (DateDelegate), ISO date-time
+// (DateTimeDelegate) and ISO time (TimeDelegate).
+inline QVariant convert(const QString& text, ColumnType type) {
+    bool ok = false;
+    switch (type) {
+        case ColumnType::Integer: {
+            const qlonglong value = text.toLongLong(&ok);
+            return ok ? QVariant(value) : QVariant();
+        }
+        case ColumnType::Double: {
+            const double value = text.toDouble(&ok);
+            return ok && qIsFinite(value) ? QVariant(value) : QVariant();
+        }
+        case ColumnType::Bool:
+            if (text.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0)
+                return true;
+            if (text.compare(QLatin1String("false"), Qt::CaseInsensitive) == 0)
+                return false;
+            return QVariant();
+        case ColumnType::Date: {
+            const QDate date = QDate::fromString(text, "yyyy-MM-dd");
+            return date.isValid() ? QVariant(date) : QVariant();
+        }
+        case ColumnType::DateTime: {
+            if (!text.contains('T'))
+                return QVariant();
+            const QDateTime dateTime = QDateTime::fromString(text, Qt::ISODate);
+            return dateTime.isValid() ? QVariant(dateTime) : QVariant();
+        }
+        case ColumnType::Time: {
+            const QTime time = QTime::fromString(text, Qt::ISODate);
+            return time.isValid() ? QVariant(time) : QVariant();
+        }
+        case ColumnType::Text:
+            break;
+    }
+    return text;
+}
+
+// The column type of a value produced by convert(); Text for anything else.
+inline ColumnType typeOf(const QVariant& value) {
+    switch (value.metaType().id()) {
+        case QMetaType::LongLong:
+            return ColumnType::Integer;
+        case QMetaType::Double:
+            return ColumnType::Double;
+        case QMetaType::Bool:
+            return ColumnType::Bool;
+        case QMetaType::QDate:
+            return ColumnType::Date;
+        case QMetaType::QDateTime:
+            return ColumnType::DateTime;
+        case QMetaType::QTime:
+            return ColumnType::Time;
+        default:
+            return ColumnType::Text;
+    }
+}
+
+// Picks the narrowest type that parses every non-null value in an evenly spread
+// sample of at most sampleSize rows. Columns with no values are Text.
+inline ColumnType infer(const QStringList& values, int sampleSize = 1000) {
+    static constexpr ColumnType candidates[] = {ColumnType::Integer, ColumnType::Double, ColumnType::Bool,
+                                                ColumnType::Date, ColumnType::Time, ColumnType::DateTime};
+    bool possible[std::size(candidates)];
+    std::fill(std::begin(possible), std::end(possible), true);
+
+    bool sawValue = false;
+    const int step = qMax(1, int(values.size() / qMax(1, sampleSize)));
+    for (int row = 0; row < values.size(); row += step) {
+        const QString& text = values[row];
+        if (isNull(text))
+            continue;
+
+        sawValue = true;
+        bool any = false;
+        for (size_t i = 0; i < std::size(candidates); ++i) {
+            if (possible[i])
+                possible[i] = convert(text, candidates[i]).isValid();
+            any = any || possible[i];
+        }
+        if (!any)
+            return ColumnType::Text;
+    }
+
+    if (!sawValue)
+        return ColumnType::Text;
+
+    for (size_t i = 0; i < std::size(candidates); ++i) {
+        if (possible[i])
+            return candidates[i];
+    }
+    return ColumnType::Text;
+}
+}  // namespace ColumnTypes
+
+namespace CsvScanner {
+// Returns the first byte in [p, end) equal to a or b, or to '\n' or '\r'.
+// Compares 16 bytes at a time where SSE2 is available.
+inline const char* findSpecial(const char* p, const char* end, char a, char b) {
+#ifdef TABLE_IMPORT_SSE2
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vn = _mm_set1_epi8('\n');
+    const __m128i vr = _mm_set1_epi8('\r');
+
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)),
+                                          _mm_or_si128(_mm_cmpeq_epi8(chunk, vn), _mm_cmpeq_epi8(chunk, vr)));
+        const int mask = _mm_movemask_epi8(hits);
+        if (mask)
+            return p + qCountTrailingZeroBits(quint32(mask));
+        p += 16;
+    }
+#endif
+
+    for (; p < end; ++p) {
+        const char c = *p;
+        if (c == a || c == b || c == '\n' || c == '\r')
+            return p;
+    }
+    return end;
+}
+
+// Returns the first occurrence of c in [p, end), or end.
+inline const char* find(const char* p, const char* end, char c) {
+    const void* hit = memchr(p, c, size_t(end - p));
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+// Returns the start of the record following p, given whether p lies inside a quoted field.
+inline const char* nextRecord(const char* p, const char* end, char quote, bool inQuotes) {
+    for (; p < end; ++p) {
+        if (*p == quote)
+            inQuotes = !inQuotes;
+        else if (!inQuotes && (*p == '\n' || *p == '\r'))
+            return p + 1;
+    }
+    return end;
+}
+}  // namespace CsvScanner
+
+// Splits UTF-8 CSV text into records. Quoted fields may contain delimiters, doubled
+// quotes and line breaks; quotes inside unquoted fields are kept as text. Blank lines
+// are skipped. Calls sink.field(QString) for every field and sink.endRow() after each record.
+template <typename Sink>
+void parseCsv(const char* p, const char* end, const CsvDialect& dialect, Sink& sink) {
+    const char delimiter = dialect.delimiter;
+    const char quote = dialect.quote;
+
+    // Skip a UTF-8 byte order mark
+    if (end - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0)
+        p += 3;
+
+    while (p < end) {
+        if (*p == '\n' || *p == '\r') {
+            ++p;
+            continue;
+        }
+
+        for (;;) {
+            QString value;
+
+            if (p < end && *p == quote) {
+                const char* start = ++p;
+                QByteArray unescaped;
+                bool escaped = false;
+
+                for (;;) {
+                    const char* closing = CsvScanner::find(p, end, quote);
+                    if (closing + 1 < end && closing[1] == quote) {
+                        unescaped.append(p, closing - p + 1);
+                        p = closing + 2;
+                        escaped = true;
+                        continue;
+                    }
+
+                    if (escaped) {
+                        unescaped.append(p, closing - p);
+                        value = QString::fromUtf8(unescaped);
+                    } else {
+                        value = QString::fromUtf8(start, closing - start);
+                    }
+                    p = closing < end ? closing + 1 : end;
+                    break;
+                }
+
+                // Keep anything between the closing quote and the delimiter
+                const char* fieldEnd = CsvScanner::findSpecial(p, end, delimiter, delimiter);
+                if (fieldEnd > p)
+                    value += QString::fromUtf8(p, fieldEnd - p);
+                p = fieldEnd;
+            } else {
+                const char* fieldEnd = CsvScanner::findSpecial(p, end, delimiter, delimiter);
+                value = QString::fromUtf8(p, fieldEnd - p);
+                p = fieldEnd;
+            }
+
+            sink.field(std::move(value));
+
+            if (p < end && *p == delimiter) {
+                ++p;
+                continue;
+            }
+
+            // End of record: consume "\n", "\r" or "\r\n"
+            if (p < end && *p == '\r')
+                ++p;
+            if (p < end && *p == '\n')
+                ++p;
+            sink.endRow();
+            break;
+        }
+    }
+}
+
+// Column-major text buffer filled by the importers and copied into the model in one pass.
+// Short records are padded with empty strings.
+struct TABLE_EXPORT ImportColumns {
+    QVector<QStringList> columns;
+    int rows = 0;
+
+    int rowCount() const { return rows; }
+    int columnCount() const { return columns.size(); }
+
+    void field(QString value) {
+        if (column == columns.size()) {
+            columns.append(QStringList());
+            columns.last().resize(rows);
+        }
+        columns[column++].append(std::move(value));
+    }
+
+    void endRow() {
+        for (; column < columns.size(); ++column) {
+            columns[column].append(QString());
+        }
+        column = 0;
+        ++rows;
+    }
+
+    // Appends the rows of another buffer, as if they had been parsed after this one.
+    void append(const ImportColumns& other) {
+        while (columns.size() < other.columns.size()) {
+            columns.append(QStringList());
+            columns.last().resize(rows);
+        }
+
+        for (int col = 0; col < columns.size(); ++col) {
+            if (col < other.columns.size())
+                columns[col].append(other.columns[col]);
+            else
+                columns[col].resize(rows + other.rows);
+        }
+        rows += other.rows;
+    }
+
+   private:
+    int column = 0;
+};
+
+// Sink used by TableWidget::loadCsv. Routes the first record to fieldNames when the
+// dialect has a header line and everything else into the column buffer.
+struct TABLE_EXPORT CsvImportSink {
+    ImportColumns data;
+    QStringList fieldNames;
+    bool headerPending = false;
+
+    explicit CsvImportSink(const CsvDialect& dialect) : headerPending(dialect.hasHeader) {}
+
+    void field(QString value) {
+        if (headerPending)
+            fieldNames.append(std::move(value));
+        else
+            data.field(std::move(value));
+    }
+
+    void endRow() {
+        if (headerPending)
+            headerPending = false;
+        else
+            data.endRow();
+    }
+};
+
+// Parses CSV on several threads and returns the rows in file order.
+//
+// The body is cut into chunkCount pieces. Quotes are counted per piece in parallel;
+// the running parity tells whether a cut lands inside a quoted field, and each cut is
+// then moved to the next record boundary outside quotes. The pieces are parsed
+// concurrently into their own column buffers, which are concatenated at the end.
+// Parity only holds for well-formed CSV where quotes enclose fields, so quotes inside
+// unquoted fields can misplace a cut.
+inline ImportColumns parseCsvParallel(const char* begin, const char* end, const CsvDialect& dialect,
+                                      QStringList* fieldNames = nullptr,
+                                      int chunkCount = QThread::idealThreadCount()) {
+    const char* body = begin;
+    if (dialect.hasHeader) {
+        body = CsvScanner::nextRecord(begin, end, dialect.quote, false);
+        CsvImportSink header(dialect);
+        parseCsv(begin, body, dialect, header);
+        if (fieldNames)
+            *fieldNames = header.fieldNames;
+    }
+
+    // Not worth the thread hand-off for small inputs
+    constexpr qint64 minChunkSize = 1 << 20;
+    chunkCount = int(qBound<qint64>(1, (end - body) / minChunkSize, qMax(1, chunkCount)));
+
+    struct Chunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        qint64 quotes = 0;
+        ImportColumns data;
+    };
+
+    QVector<Chunk> chunks(chunkCount);
+    const qint64 chunkSize = (end - body) / chunkCount;
+    for (int i = 0; i < chunkCount; ++i) {
+        chunks[i].begin = body + i * chunkSize;
+        chunks[i].end = i + 1 < chunkCount ? body + (i + 1) * chunkSize : end;
+    }
+
+    if (chunkCount > 1) {
+        QtConcurrent::blockingMap(chunks, [quote = dialect.quote](Chunk& chunk) {
+            chunk.quotes = std::count(chunk.begin, chunk.end, quote);
+        });
+
+        // Move every cut to a record boundary, using the quote parity at the cut.
+        bool inQuotes = false;
+        for (int i = 1; i < chunkCount; ++i) {
+            inQuotes = inQuotes != bool(chunks[i - 1].quotes & 1);
+            const char* nominal = body + i * chunkSize;
+            const char* start = CsvScanner::nextRecord(nominal, end, dialect.quote, inQuotes);
+            chunks[i].begin = qMax(start, chunks[i - 1].begin);
+            chunks[i - 1].end = chunks[i].begin;
+        }
+        chunks.last().end = end;
+    }
+
+    QtConcurrent::blockingMap(chunks, [&dialect](Chunk& chunk) {
+        if (chunk.begin < chunk.end)
+            parseCsv(chunk.begin, chunk.end, dialect, chunk.data);
+    });
+
+    ImportColumns result = std::move(chunks[0].data);
+    for (int i = 1; i < chunkCount; ++i) {
+        result.append(chunks[i].data);
+        chunks[i].data = ImportColumns();
+    }
+    return result;
+}
+
+// Pull reader for the array-of-objects format written by generateJsonData, or for
+// NDJSON (one object per line). The input is read from the device in blocks and only
+// the object currently being decoded is kept in memory, so the whole input is never
+// held as a single QJsonDocument.
+class TABLE_EXPORT JsonRowReader {
+   public:
+    explicit JsonRowReader(QIODevice* device, bool lineDelimited = false)
+        : device(device), lineDelimited(lineDelimited) {}
+
+    // Reads the next object. Returns false at the end of the input or on error.
+    // With keyOrder, also stores the object's keys in the order they appear in the input.
+    bool readNext(QJsonObject& object, QStringList* keyOrder = nullptr) {
+        this->keyOrder = keyOrder;
+        return lineDelimited ? readLine(object) : readArrayElement(object);
+    }
+
+    // Keys of an object's JSON text in written order. QJsonObject keeps its keys
+    // sorted, so the order can only come from the text.
+    static QStringList keysInOrder(const QByteArray& json) {
+        QStringList keys;
+        int depth = 0;
+        bool inString = false;
+        bool escaped = false;
+        qsizetype stringStart = 0;
+        for (qsizetype i = 0; i < json.size(); ++i) {
+            const char c = json[i];
+            if (inString) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    inString = false;
+                    if (depth != 1)
+                        continue;
+
+                    // A string directly inside the object followed by ':' is a key
+                    qsizetype next = i + 1;
+                    while (next < json.size() && isspace(uchar(json[next]))) {
+                        ++next;
+                    }
+                    if (next < json.size() && json[next] == ':') {
+                        const QByteArray quoted = "[" + json.mid(stringStart, i + 1 - stringStart) + "]";
+                        keys.append(QJsonDocument::fromJson(quoted).array().at(0).toString());
+                    }
+                }
+            } else if (c == '"') {
+                inString = true;
+                stringStart = i;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                --depth;
+            }
+        }
+        keys.removeDuplicates();
+        return keys;
+    }
+
+    bool hasError() const { return !error.isEmpty(); }
+    QString errorString() const { return error; }
+
+   private:
+    bool readLine(QJsonObject& object) {
+        while (!device->atEnd()) {
+            const QByteArray line = device->readLine().trimmed();
+            if (line.isEmpty())
+                continue;
+            return parseObject(line, object);
+        }
+        return false;
+    }
+
+    bool readArrayElement(QJsonObject& object) {
+        // Skip the opening bracket, separators and whitespace up to the next object
+        for (;;) {
+            if (pos == buffer.size() && !fill())
+                return fail(started ? "Unterminated JSON array" : QString());
+
+            const char c = buffer[pos];
+            if (c == '{')
+                break;
+
+            if (c == '[' && !started) {
+                started = true;
+            } else if (c == ']' && started) {
+                return false;
+            } else if (!(c == ',' && started) && !isspace(uchar(c))) {
+                return fail("Expected an array of JSON objects");
+            }
+            ++pos;
+        }
+
+        // Find the matching closing brace, reading more input as needed.
+        int depth = 0;
+        bool inString = false;
+        bool escaped = false;
+        qsizetype i = pos;
+        for (;; ++i) {
+            if (i == buffer.size()) {
+                const qsizetype offset = i - pos;
+                if (!fill())
+                    return fail("Unterminated JSON object");
+                i = pos + offset;
+            }
+
+            const char c = buffer[i];
+            if (inString) {
+                if (escaped)
+                    escaped = false;
+                else if (c == '\\')
+                    escaped = true;
+                else if (c == '"')
+                    inString = false;
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0)
+                    break;
+            }
+        }
+
+        const bool ok = parseObject(QByteArray::fromRawData(buffer.constData() + pos, i + 1 - pos), object);
+        pos = i + 1;
+        return ok;
+    }
+
+    // Appends the next block of input, dropping what has already been consumed.
+    bool fill() {
+        if (device->atEnd())
+            return false;
+
+        buffer.remove(0, pos);
+        pos = 0;
+        const QByteArray block = device->read(blockSize);
+        buffer.append(block);
+        return !block.isEmpty();
+    }
+
+    bool parseObject(const QByteArray& json, QJsonObject& object) {
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !document.isObject())
+            return fail(parseError.errorString());
+
+        object = document.object();
+        if (keyOrder)
+            *keyOrder = keysInOrder(json);
+        return true;
+    }
+
+    bool fail(const QString& message) {
+        error = message;
+        return false;
+    }
+
+    static constexpr qint64 blockSize = 1 << 16;
+
+    QIODevice* device;
+    bool lineDelimited;
+    QStringList* keyOrder = nullptr;
+    bool started = false;
+    QByteArray buffer;
+    qsizetype pos = 0;
+    QString error;
+};
+
+// Cell text for a JSON value: strings as-is, numbers and booleans as written by
+// generateJsonData, null as empty and nested values as compact JSON.
+inline QString jsonCellText(const QJsonValue& value) {
+    switch (value.type()) {
+        case QJsonValue::String:
+            return value.toString();
+        case QJsonValue::Double:
+        case QJsonValue::Bool:
+            return value.toVariant().toString();
+        case QJsonValue::Array:
+            return QString::fromUtf8(QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact));
+        case QJsonValue::Object:
+            return QString::fromUtf8(QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+        default:
+            return QString();
+    }
+}
+
+// Reads all objects from reader into a column buffer. keys gives the object key for
+// each column; when empty, the keys of the first object, in file order, are used and
+// stored in keys.
+// Keys without a column are ignored.
+inline bool readJsonRows(JsonRowReader& reader, QStringList& keys, ImportColumns& data) {
+    QHash<QString, int> columnOf;
+    for (int col = 0; col < keys.size(); ++col) {
+        columnOf.insert(keys[col], col);
+    }
+
+    QJsonObject object;
+    QStringList values;
+    const bool deriveKeys = keys.isEmpty();
+    while (reader.readNext(object, deriveKeys && keys.isEmpty() ? &keys : nullptr)) {
+        if (deriveKeys && columnOf.isEmpty()) {
+            for (int col = 0; col < keys.size(); ++col) {
+                columnOf.insert(keys[col], col);
+            }
+        }
+
+        values.fill(QString(), keys.size());
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            const int col = columnOf.value(it.key(), -1);
+            if (col >= 0)
+                values[col] = jsonCellText(it.value());
+        }
+
+        for (QString& value : values) {
+            data.field(std::move(value));
+        }
+        data.endRow();
+    }
+    return !reader.hasError();
+}
+
+// Bounded hand-off of parsed batches from an import worker to the GUI thread.
+// push() blocks while the queue is full, which caps memory at a few batches
+// however far the parser runs ahead of the model.
+class TABLE_EXPORT ImportBatchQueue {
+   public:
+    explicit ImportBatchQueue(int capacity = 4) : capacity(capacity) {}
+
+    // Called by the worker. Returns false once the import has been cancelled.
+    bool push(ImportColumns batch, qint64 bytesDone) {
+        QMutexLocker locker(&mutex);
+        while (batches.size() >= capacity && !cancelled) {
+            notFull.wait(&mutex);
+        }
+        if (cancelled)
+            return false;
+
+        batches.enqueue(std::move(batch));
+        bytesRead.store(bytesDone, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Called by the worker after its last push.
+    void finish(const QString& errorString = QString()) {
+        QMutexLocker locker(&mutex);
+        finished = true;
+        error = errorString;
+    }
+
+    bool tryPop(ImportColumns& batch) {
+        QMutexLocker locker(&mutex);
+        if (batches.isEmpty())
+            return false;
+
+        batch = batches.dequeue();
+        notFull.wakeOne();
+        return true;
+    }
+
+    void cancel() {
+        QMutexLocker locker(&mutex);
+        cancelled = true;
+        batches.clear();
+        notFull.wakeAll();
+    }
+
+    bool isCancelled() const {
+        QMutexLocker locker(&mutex);
+        return cancelled;
+    }
+
+    // True once the worker has finished and every batch has been taken.
+    bool isDone() const {
+        QMutexLocker locker(&mutex);
+        return finished && batches.isEmpty();
+    }
+
+    QString errorString() const {
+        QMutexLocker locker(&mutex);
+        return error;
+    }
+
+    qint64 bytesDone() const { return bytesRead.load(std::memory_order_relaxed); }
+
+   private:
+    mutable QMutex mutex;
+    QWaitCondition notFull;
+    QQueue<ImportColumns> batches;
+    int capacity;
+    bool finished = false;
+    bool cancelled = false;
+    QString error;
+    std::atomic<qint64> bytesRead{0};
+};
+
+// Parses [body, end) in slices of about sliceSize bytes, each cut at a record boundary,
+// and pushes one column buffer per slice. Runs on the import worker thread.
+inline void readCsvSlices(const char* body, const char* end, const CsvDialect& dialect,
+                          ImportBatchQueue& queue, qint64 sliceSize = 1 << 20) {
+    const char* start = body;
+    while (start < end) {
+        const char* nominal = start + qMin<qint64>(sliceSize, end - start);
+        const bool inQuotes = std::count(start, nominal, dialect.quote) & 1;
+        const char* sliceEnd = nominal < end ? CsvScanner::nextRecord(nominal, end, dialect.quote, inQuotes) : end;
+
+        ImportColumns batch;
+        parseCsv(start, sliceEnd, dialect, batch);
+        if (!queue.push(std::move(batch), sliceEnd - body))
+            return;
+        start = sliceEnd;
+    }
+    queue.finish();
+}
+
+// Unbounded lock-free multi-producer, single-consumer queue (Vyukov's node-based design).
+// push() may be called from any thread and never blocks; pop() must only be called
+// from one consumer thread. An element pushed concurrently with pop() may become
+// visible on the next pop().
+template <typename T>
+class MpscQueue {
+   public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head.store(stub, std::memory_order_relaxed);
+        tail = stub;
+    }
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    bool pop(T& value) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+   private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    std::atomic<Node*> head;
+    Node* tail;
+};
+
+#endif  // TABLE_IMPORT_H
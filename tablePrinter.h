@@ -0,0 +1,493 @@
+#ifndef TABLE_PRINTER_H
+#define TABLE_PRINTER_H
+
+#include <QAbstractScrollArea>
+#include <QApplication>
+#include <QDialog>
+#include <QFontMetricsF>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QLabel>
+#include <QPagedPaintDevice>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QPrintDialog>
+#include <QPrinter>
+#include <QScrollBar>
+#include <QTimer>
+#include <QToolBar>
+#include <QUrl>
+#include <QVBoxLayout>
+#include <QVector>
+#include <QtConcurrent>
+#include <memory>
+#include "tableExport.h"
+#include "tableWidget_global.h"
+
+// Page setup for TableWidget::exportPdf.
+struct TABLE_EXPORT PdfExportOptions {
+    QPageSize pageSize = QPageSize(QPageSize::A4);
+    QPageLayout::Orientation orientation = QPageLayout::Portrait;
+    QMarginsF margins = QMarginsF(15, 15, 15, 15);  // Millimeters
+    int resolution = 300;
+    QString title;  // Document title; defaults to the table title.
+};
+
+// Paginates a TableSnapshot and paints it page by page with QPainter.
+//
+// Layout happens once, in points (1/72 inch) with pixel-sized fonts, so the same
+// pagination renders identically on printers, PDF writers and preview images:
+// scale the painter by device dpi / 72 and call paintPage() for any page, in any order.
+// Column widths are measured from the headers and a sample of the rows; cell text
+// that does not fit is elided. The header row is repeated on every page.
+class TABLE_EXPORT TablePrintEngine {
+   public:
+    explicit TablePrintEngine(TableSnapshot data, const QString& title = QString(),
+                              const QUrl& logo = QUrl())
+        : data(std::move(data)), title(title), logoUrl(logo) {
+        bodyFont = QApplication::font();
+        bodyFont.setPixelSize(9);
+        headerFont = bodyFont;
+        headerFont.setBold(true);
+        titleFont = headerFont;
+        titleFont.setPixelSize(14);
+    }
+
+    // Measures the columns and splits the rows into pages of pageSize points.
+    // Safe to call from a worker thread.
+    void layout(const QSizeF& pageSize) {
+        page = pageSize;
+
+        const QFontMetricsF bodyMetrics(bodyFont);
+        const QFontMetricsF headerMetrics(headerFont);
+        const QFontMetricsF titleMetrics(titleFont);
+
+        rowHeight = bodyMetrics.height() + 2 * cellPadding;
+        headerHeight = headerMetrics.height() + 2 * cellPadding;
+        footerHeight = bodyMetrics.height() + cellPadding;
+
+        titleHeight = 0;
+        if (!title.isEmpty())
+            titleHeight += titleMetrics.height() + 4;
+        if (!logoUrl.isEmpty()) {
+            logo = QImage(logoPath());
+            if (!logo.isNull())
+                titleHeight += logoSize + 4;
+        }
+        if (titleHeight > 0)
+            titleHeight += 12;
+
+        measureColumns(bodyMetrics, headerMetrics);
+
+        const qreal tableHeight = page.height() - headerHeight - footerHeight;
+        rowsPerPage = qMax(1, int(tableHeight / rowHeight));
+        rowsOnFirstPage = qMax(1, int((tableHeight - titleHeight) / rowHeight));
+
+        const int remaining = qMax(0, data.rowCount() - rowsOnFirstPage);
+        pages = 1 + (remaining + rowsPerPage - 1) / rowsPerPage;
+    }
+
+    int pageCount() const { return pages; }
+    QSizeF pageSize() const { return page; }
+
+    // Rows [first, first + count) painted on the given zero-based page.
+    int firstRowOnPage(int pageIndex) const {
+        return pageIndex == 0 ? 0 : rowsOnFirstPage + (pageIndex - 1) * rowsPerPage;
+    }
+
+    int rowCountOnPage(int pageIndex) const {
+        const int first = firstRowOnPage(pageIndex);
+        const int capacity = pageIndex == 0 ? rowsOnFirstPage : rowsPerPage;
+        return qBound(0, data.rowCount() - first, capacity);
+    }
+
+    // Paints one zero-based page. The painter must be set up in points,
+    // with the origin at the top left of the printable area.
+    void paintPage(QPainter* painter, int pageIndex) const {
+        painter->save();
+
+        qreal y = 0;
+        if (pageIndex == 0 && titleHeight > 0) {
+            y = paintTitle(painter);
+        }
+
+        y = paintHeader(painter, y);
+
+        const int first = firstRowOnPage(pageIndex);
+        const int count = rowCountOnPage(pageIndex);
+
+        painter->setFont(bodyFont);
+        const QFontMetricsF metrics(bodyFont);
+        for (int row = first; row < first + count; ++row) {
+            const QStringList& values = data.rows[row];
+            qreal x = 0;
+            for (int col = 0; col < columnWidths.size(); ++col) {
+                const QRectF cell(x, y, columnWidths[col], rowHeight);
+                painter->setPen(borderColor);
+                painter->drawRect(cell);
+                painter->setPen(Qt::black);
+                paintText(painter, metrics, cell, values.value(col));
+                x += columnWidths[col];
+            }
+            y += rowHeight;
+        }
+
+        painter->setPen(Qt::darkGray);
+        const QRectF footer(0, page.height() - footerHeight, page.width(), footerHeight);
+        painter->drawText(footer, Qt::AlignRight | Qt::AlignBottom,
+                          QString("Page %1 of %2").arg(pageIndex + 1).arg(pages));
+
+        painter->restore();
+    }
+
+    // Prints pages [fromPage, toPage] (one-based, 0 means first/last) to a printer
+    // or PDF writer, one page at a time.
+    bool print(QPagedPaintDevice* device, int fromPage = 0, int toPage = 0) {
+        layout(device->pageLayout().paintRect(QPageLayout::Point).size());
+
+        const int first = fromPage > 0 ? qMin(fromPage, pages) - 1 : 0;
+        const int last = toPage > 0 ? qMin(toPage, pages) - 1 : pages - 1;
+
+        QPainter painter;
+        if (!painter.begin(device))
+            return false;
+
+        for (int pageIndex = first; pageIndex <= last; ++pageIndex) {
+            if (pageIndex > first)
+                device->newPage();
+
+            painter.save();
+            painter.scale(device->logicalDpiX() / 72.0, device->logicalDpiY() / 72.0);
+            paintPage(&painter, pageIndex);
+            painter.restore();
+        }
+        return painter.end();
+    }
+
+    // Prints to a printer, honouring the page range chosen in the print dialog.
+    bool print(QPrinter* printer) {
+        return print(static_cast<QPagedPaintDevice*>(printer), printer->fromPage(), printer->toPage());
+    }
+
+   private:
+    void measureColumns(const QFontMetricsF& bodyMetrics, const QFontMetricsF& headerMetrics) {
+        const int columns = data.columnCount();
+        QVector<qreal> natural(columns, 0);
+
+        for (int col = 0; col < columns; ++col) {
+            natural[col] = headerMetrics.horizontalAdvance(data.headers.value(col));
+        }
+
+        // Measure a bounded, evenly spread sample so long tables lay out in constant time.
+        const int rows = data.rowCount();
+        const int step = qMax(1, rows / maxMeasuredRows);
+        for (int row = 0; row < rows; row += step) {
+            const QStringList& values = data.rows[row];
+            for (int col = 0; col < columns && col < values.size(); ++col) {
+                natural[col] = qMax(natural[col], bodyMetrics.horizontalAdvance(values[col]));
+            }
+        }
+
+        // Scale the natural widths to span the page, like a 100% wide html table.
+        qreal total = 0;
+        for (qreal& width : natural) {
+            width += 2 * cellPadding;
+            total += width;
+        }
+
+        columnWidths.resize(columns);
+        for (int col = 0; col < columns; ++col) {
+            columnWidths[col] = total > 0 ? natural[col] * page.width() / total : 0;
+        }
+    }
+
+    qreal paintTitle(QPainter* painter) const {
+        qreal y = 0;
+        if (!title.isEmpty()) {
+            painter->setFont(titleFont);
+            painter->setPen(Qt::black);
+            const qreal height = QFontMetricsF(titleFont).height();
+            painter->drawText(QRectF(0, y, page.width(), height), Qt::AlignHCenter | Qt::AlignVCenter, title);
+            y += height + 4;
+        }
+
+        if (!logo.isNull()) {
+            const QRectF target((page.width() - logoSize) / 2, y, logoSize, logoSize);
+            painter->drawImage(target, logo);
+            y += logoSize + 4;
+        }
+        return titleHeight;
+    }
+
+    qreal paintHeader(QPainter* painter, qreal y) const {
+        painter->setFont(headerFont);
+        const QFontMetricsF metrics(headerFont);
+
+        qreal x = 0;
+        for (int col = 0; col < columnWidths.size(); ++col) {
+            const QRectF cell(x, y, columnWidths[col], headerHeight);
+            painter->fillRect(cell, headerBackground);
+            painter->setPen(borderColor);
+            painter->drawRect(cell);
+            painter->setPen(Qt::black);
+            paintText(painter, metrics, cell, data.headers.value(col));
+            x += columnWidths[col];
+        }
+        return y + headerHeight;
+    }
+
+    void paintText(QPainter* painter, const QFontMetricsF& metrics, const QRectF& cell, const QString& text) const {
+        const QRectF textRect = cell.adjusted(cellPadding, 0, -cellPadding, 0);
+        const QString elided = metrics.elidedText(text, Qt::ElideRight, textRect.width());
+        painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, elided);
+    }
+
+    QString logoPath() const {
+        if (logoUrl.isLocalFile())
+            return logoUrl.toLocalFile();
+        if (logoUrl.scheme() == "qrc")
+            return ":" + logoUrl.path();
+        return logoUrl.toString();
+    }
+
+    static constexpr int maxMeasuredRows = 2000;
+    static constexpr qreal cellPadding = 4;
+    static constexpr qreal logoSize = 48;
+
+    TableSnapshot data;
+    QString title;
+    QUrl logoUrl;
+    QImage logo;
+
+    QFont bodyFont;
+    QFont headerFont;
+    QFont titleFont;
+    QColor borderColor = QColor("#dddddd");
+    QColor headerBackground = QColor("#f2f2f2");
+
+    QSizeF page;
+    QVector<qreal> columnWidths;
+    qreal rowHeight = 0;
+    qreal headerHeight = 0;
+    qreal footerHeight = 0;
+    qreal titleHeight = 0;
+    int rowsPerPage = 1;
+    int rowsOnFirstPage = 1;
+    int pages = 1;
+};
+
+// Scrollable page view over a TablePrintEngine. Only the pages in view, plus a
+// small lookahead, are rendered; everything else is dropped from the cache.
+class TABLE_EXPORT TablePageView : public QAbstractScrollArea {
+   public:
+    explicit TablePageView(QWidget* parent = nullptr) : QAbstractScrollArea(parent) {
+        viewport()->setBackgroundRole(QPalette::Dark);
+        viewport()->setAutoFillBackground(true);
+    }
+
+    // Sets the page geometry used to place the printable area on each page.
+    void setPageLayout(const QPageLayout& layout) {
+        pageRect = layout.fullRect(QPageLayout::Point);
+        paintRect = layout.paintRect(QPageLayout::Point);
+        refresh();
+    }
+
+    // Sets an engine that has already been laid out for the current page layout.
+    void setEngine(std::shared_ptr<TablePrintEngine> printEngine) {
+        engine = std::move(printEngine);
+        refresh();
+    }
+
+    qreal zoom() const { return zoomFactor; }
+
+    void setZoom(qreal zoom) {
+        const qreal position = verticalScrollBar()->maximum() > 0
+                                   ? qreal(verticalScrollBar()->value()) / verticalScrollBar()->maximum()
+                                   : 0;
+        zoomFactor = qBound(0.25, zoom, 4.0);
+        refresh();
+        verticalScrollBar()->setValue(qRound(position * verticalScrollBar()->maximum()));
+    }
+
+   protected:
+    void paintEvent(QPaintEvent* event) override {
+        Q_UNUSED(event);
+        QPainter painter(viewport());
+
+        if (!engine) {
+            painter.drawText(viewport()->rect(), Qt::AlignCenter, "Laying out pages...");
+            return;
+        }
+
+        const QSize pageSize = pagePixelSize();
+        const int stride = pageSize.height() + pageGap;
+        const int scrollY = verticalScrollBar()->value();
+        const int x = qMax(pageGap, (viewport()->width() - pageSize.width()) / 2) - horizontalScrollBar()->value();
+
+        const int first = qMax(0, (scrollY - pageGap) / stride);
+        int last = first;
+        for (int page = first; page < engine->pageCount(); ++page) {
+            const int top = pageGap + page * stride - scrollY;
+            if (top > viewport()->height())
+                break;
+
+            painter.drawImage(QPoint(x, top), pageImage(page));
+            last = page;
+        }
+
+        // Keep only the visible pages and their neighbours.
+        for (auto it = pageCache.begin(); it != pageCache.end();) {
+            if (it.key() < first - lookahead || it.key() > last + lookahead)
+                it = pageCache.erase(it);
+            else
+                ++it;
+        }
+
+        QTimer::singleShot(0, this, [this, last]() { renderAhead(last); });
+    }
+
+    void resizeEvent(QResizeEvent* event) override {
+        QAbstractScrollArea::resizeEvent(event);
+        updateScrollBars();
+    }
+
+    void scrollContentsBy(int dx, int dy) override {
+        Q_UNUSED(dx);
+        Q_UNUSED(dy);
+        viewport()->update();
+    }
+
+   private:
+    qreal scale() const { return zoomFactor * logicalDpiX() / 72.0; }
+
+    QSize pagePixelSize() const { return (pageRect.size() * scale()).toSize(); }
+
+    void refresh() {
+        pageCache.clear();
+        updateScrollBars();
+        viewport()->update();
+    }
+
+    void updateScrollBars() {
+        const QSize pageSize = pagePixelSize();
+        const int pages = engine ? engine->pageCount() : 0;
+        const int contentHeight = pages * (pageSize.height() + pageGap) + pageGap;
+        const int contentWidth = pageSize.width() + 2 * pageGap;
+
+        verticalScrollBar()->setRange(0, qMax(0, contentHeight - viewport()->height()));
+        verticalScrollBar()->setPageStep(viewport()->height());
+        verticalScrollBar()->setSingleStep(qMax(1, pageSize.height() / 20));
+        horizontalScrollBar()->setRange(0, qMax(0, contentWidth - viewport()->width()));
+        horizontalScrollBar()->setPageStep(viewport()->width());
+    }
+
+    QImage pageImage(int page) {
+        auto cached = pageCache.constFind(page);
+        if (cached != pageCache.constEnd())
+            return *cached;
+
+        const QImage image = renderPage(page);
+        pageCache.insert(page, image);
+        return image;
+    }
+
+    QImage renderPage(int page) const {
+        const qreal ratio = devicePixelRatioF();
+        QImage image((pageRect.size() * scale() * ratio).toSize(), QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(ratio);
+        image.fill(Qt::white);
+
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.scale(scale(), scale());
+        painter.translate(paintRect.topLeft());
+        engine->paintPage(&painter, page);
+        return image;
+    }
+
+    void renderAhead(int lastVisible) {
+        if (!engine)
+            return;
+
+        for (int page = lastVisible + 1; page <= lastVisible + lookahead && page < engine->pageCount(); ++page) {
+            if (!pageCache.contains(page))
+                pageCache.insert(page, renderPage(page));
+        }
+    }
+
+    static constexpr int pageGap = 12;
+    static constexpr int lookahead = 2;
+
+    std::shared_ptr<TablePrintEngine> engine;
+    QRectF pageRect;
+    QRectF paintRect;
+    qreal zoomFactor = 1.0;
+    QHash<int, QImage> pageCache;
+};
+
+// Print preview for a TablePrintEngine. Pagination runs on a worker thread and
+// the dialog is usable immediately; pages are rendered as they scroll into view.
+class TABLE_EXPORT TablePrintPreviewDialog : public QDialog {
+   public:
+    explicit TablePrintPreviewDialog(TablePrintEngine printEngine, QWidget* parent = nullptr)
+        : QDialog(parent),
+          printer(QPrinter::HighResolution),
+          engine(std::make_shared<TablePrintEngine>(std::move(printEngine))) {
+        setMinimumSize(800, 600);
+        setWindowTitle("Print Preview");
+        setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+
+        QToolBar* toolBar = new QToolBar(this);
+        QAction* printAction = toolBar->addAction("Print");
+        QAction* zoomInAction = toolBar->addAction("Zoom In");
+        QAction* zoomOutAction = toolBar->addAction("Zoom Out");
+        toolBar->addSeparator();
+        pageLabel = new QLabel("Laying out pages...", toolBar);
+        toolBar->addWidget(pageLabel);
+
+        view = new TablePageView(this);
+        view->setPageLayout(printer.pageLayout());
+
+        QVBoxLayout* layout = new QVBoxLayout(this);
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->addWidget(toolBar);
+        layout->addWidget(view);
+
+        connect(zoomInAction, &QAction::triggered, this, [this]() { view->setZoom(view->zoom() * 1.25); });
+        connect(zoomOutAction, &QAction::triggered, this, [this]() { view->setZoom(view->zoom() / 1.25); });
+        connect(printAction, &QAction::triggered, this, [this]() { print(); });
+
+        connect(&layoutWatcher, &QFutureWatcher<void>::finished, this, [this]() { showPages(); });
+
+        const QSizeF pageSize = printer.pageLayout().paintRect(QPageLayout::Point).size();
+        layoutWatcher.setFuture(QtConcurrent::run([engine = engine, pageSize]() { engine->layout(pageSize); }));
+    }
+
+   private:
+    void showPages() {
+        view->setPageLayout(printer.pageLayout());
+        view->setEngine(engine);
+        pageLabel->setText(QString("%1 pages").arg(engine->pageCount()));
+    }
+
+    void print() {
+        if (!layoutWatcher.isFinished())
+            return;
+
+        QPrintDialog printDialog(&printer, this);
+        if (printDialog.exec() == QDialog::Accepted) {
+            engine->print(&printer);
+            // The dialog may have changed the paper size or orientation.
+            showPages();
+        }
+    }
+
+    QPrinter printer;
+    std::shared_ptr<TablePrintEngine> engine;
+    QFutureWatcher<void> layoutWatcher;
+    TablePageView* view;
+    QLabel* pageLabel;
+};
+
+#endif  // TABLE_PRINTER_H
@@ -1,6 +1,7 @@
 #ifndef TABLE_WIDGET_H
 #define TABLE_WIDGET_H
 
+#include <QFuture>
 #include <QHeaderView>
 #include <QList>
 #include <QPainter>
@@ -8,42 +9,115 @@
 #include <QPrintPreviewDialog>
 #include <QPrintPreviewWidget>
 #include <QPrinter>
+#include <QPromise>
 #include <QRegularExpression>
 #include <QTableWidget>
 #include <QTableWidgetItem>
+#include <QtConcurrent>
 #include <QtWidgets>
+#include <algorithm>
 #include <tuple>
 #include <type_traits>
+#include "tableBinary.h"
+#include "tableExport.h"
+#include "tableImport.h"
+#include "tablePrinter.h"
 #include "tableWidget_global.h"
 
+// Sorts cells with a typed value (ColumnTypes::ValueRole) by that value, so imported
+// numbers and dates order numerically and chronologically rather than as text. Cells
+// without one sort after those that have one, by text as before.
+class TABLE_EXPORT TableProxyModel : public QSortFilterProxyModel {
+   public:
+    using QSortFilterProxyModel::QSortFilterProxyModel;
+
+   protected:
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override {
+        const QVariant leftValue = left.data(ColumnTypes::ValueRole);
+        const QVariant rightValue = right.data(ColumnTypes::ValueRole);
+        if (leftValue.isValid() != rightValue.isValid())
+            return leftValue.isValid();
+
+        if (leftValue.isValid()) {
+            const QPartialOrdering order = QVariant::compare(leftValue, rightValue);
+            if (order == QPartialOrdering::Less)
+                return true;
+            if (order == QPartialOrdering::Greater)
+                return false;
+        }
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+};
+
 class TABLE_EXPORT HtmlPreviewWidget : public QPrintPreviewWidget {
    public:
     HtmlPreviewWidget(QString html)
         : htmlContent(html) {
+        // Parse once; the document is only laid out again when the widget is resized.
+        document.setHtml(htmlContent);
+        document.setDefaultTextOption(QTextOption(Qt::AlignLeft | Qt::AlignTop));
+        document.setPageSize(size());
         updatePreview();
     }
 
    protected:
+    void resizeEvent(QResizeEvent* event) override {
+        QPrintPreviewWidget::resizeEvent(event);
+        document.setPageSize(size());
+        pageCache.clear();
+    }
+
     void paintEvent(QPaintEvent* event) override {
         QPrintPreviewWidget::paintEvent(event);
 
-        QPainter painter(this);
-        QTextDocument doc;
-
-        doc.setHtml(htmlContent);
-        doc.setDefaultTextOption(QTextOption(Qt::AlignLeft | Qt::AlignTop));
-        doc.setPageSize(size());
+        // Cached pages are only valid for the zoom and device pixel ratio they were drawn at.
+        if (cachedZoom != zoomFactor() || cachedScale != devicePixelRatioF()) {
+            cachedZoom = zoomFactor();
+            cachedScale = devicePixelRatioF();
+            pageCache.clear();
+        }
 
-        painter.save();
-        painter.translate(rect().topLeft());
+        QPainter painter(this);
 
-        // Draw the document's contents
-        doc.drawContents(&painter);
-        painter.restore();
+        // Draw the cached pages that intersect the exposed area
+        const QSizeF pageSize = document.pageSize() * cachedZoom;
+        for (int page = 0; page < document.pageCount(); ++page) {
+            const QRectF pageRect(QPointF(0, page * pageSize.height()), pageSize);
+            if (pageRect.top() > event->rect().bottom())
+                break;
+            if (pageRect.intersects(event->rect()))
+                painter.drawPixmap(pageRect.topLeft(), pagePixmap(page));
+        }
     }
 
    private:
+    // Renders a page of the laid-out document once per size, zoom and device pixel ratio.
+    QPixmap pagePixmap(int page) {
+        auto cached = pageCache.constFind(page);
+        if (cached != pageCache.constEnd())
+            return *cached;
+
+        const QSizeF pageSize = document.pageSize();
+        QPixmap pixmap((pageSize * cachedZoom * cachedScale).toSize());
+        pixmap.setDevicePixelRatio(cachedScale);
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        const QRectF pageRect(QPointF(0, page * pageSize.height()), pageSize);
+        painter.scale(cachedZoom, cachedZoom);
+        painter.translate(0, -pageRect.top());
+        document.drawContents(&painter, pageRect);
+        painter.end();
+
+        pageCache.insert(page, pixmap);
+        return pixmap;
+    }
+
     QString htmlContent;
+    QTextDocument document;
+    QHash<int, QPixmap> pageCache;
+    qreal cachedZoom = 0;
+    qreal cachedScale = 0;
 };
 
 class TABLE_EXPORT CustomTableModel : public QStandardItemModel {
@@ -54,7 +128,14 @@ class TABLE_EXPORT CustomTableModel : public QStandardItemModel {
                               QObject* parent = nullptr)
         : QStandardItemModel(parent),
           editableColumns(editableColumns),
-          disabledColumns(disabledColumns) {}
+          disabledColumns(disabledColumns) {
+        // Keep pending deferred changes on the rows they were made to
+        connect(this, &QAbstractItemModel::rowsInserted, this,
+                [this](const QModelIndex&, int first, int last) { shiftDirtyRows(first, last - first + 1); });
+        connect(this, &QAbstractItemModel::rowsRemoved, this,
+                [this](const QModelIndex&, int first, int last) { shiftDirtyRows(last + 1, first - last - 1); });
+        connect(this, &QAbstractItemModel::modelReset, this, [this]() { dirtyColumns.clear(); });
+    }
 
     Qt::ItemFlags flags(const QModelIndex& index) const override {
         if (!index.isValid())
@@ -72,11 +153,198 @@ class TABLE_EXPORT CustomTableModel : public QStandardItemModel {
         return QStandardItemModel::flags(index);
     }
 
+    // Keeps the typed value of imported cells (ColumnTypes::ValueRole) in step with edits
+    // to their text. Text that no longer parses as the cell's type drops the typed value.
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override {
+        if (role == Qt::DisplayRole || role == Qt::EditRole) {
+            QStandardItem* cell = itemFromIndex(index);
+            const QVariant typed = cell ? cell->data(ColumnTypes::ValueRole) : QVariant();
+            if (typed.isValid()) {
+                const QSignalBlocker blocker(this);
+                cell->setData(ColumnTypes::convert(value.toString(), ColumnTypes::typeOf(typed)),
+                              ColumnTypes::ValueRole);
+            }
+        }
+        return QStandardItemModel::setData(index, value, role);
+    }
+
+    // Appends count rows and fills them in fill(firstRow) without per-item notifications.
+    // Views get one row insertion and one dataChanged for the whole block.
+    template <typename Fill>
+    void appendRowsWith(int count, Fill&& fill) {
+        const int firstRow = rowCount();
+        insertRows(firstRow, count);
+        {
+            const QSignalBlocker blocker(this);
+            fill(firstRow);
+        }
+        if (columnCount() > 0) {
+            appending = true;
+            emit dataChanged(index(firstRow, 0), index(firstRow + count - 1, columnCount() - 1));
+            appending = false;
+        }
+    }
+
+    // True while appendRowsWith reports the contents of the rows it just inserted.
+    bool isAppending() const { return appending; }
+
+    // Stores value without notifying views. The cell is reported by the next flushDirty().
+    bool setDataDeferred(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) {
+        bool changed;
+        {
+            const QSignalBlocker blocker(this);
+            changed = setData(index, value, role);
+        }
+
+        if (changed) {
+            auto span = dirtyColumns.find(index.row());
+            if (span == dirtyColumns.end()) {
+                dirtyColumns.insert(index.row(), qMakePair(index.column(), index.column()));
+            } else {
+                span->first = qMin(span->first, index.column());
+                span->second = qMax(span->second, index.column());
+            }
+        }
+        return changed;
+    }
+
+    bool hasDirtyCells() const { return !dirtyColumns.isEmpty(); }
+
+    // Reports deferred changes with one dataChanged per dirty region. Adjacent rows
+    // whose column spans overlap are merged into one rectangle.
+    void flushDirty() {
+        if (dirtyColumns.isEmpty())
+            return;
+
+        QList<int> rows = dirtyColumns.keys();
+        std::sort(rows.begin(), rows.end());
+
+        // Rows may have been removed since they were marked
+        while (!rows.isEmpty() && rows.last() >= rowCount()) {
+            rows.removeLast();
+        }
+        if (rows.isEmpty()) {
+            dirtyColumns.clear();
+            return;
+        }
+
+        int top = rows.first();
+        int bottom = top;
+        QPair<int, int> span = dirtyColumns.value(top);
+
+        for (int i = 1; i < rows.size(); ++i) {
+            const QPair<int, int> next = dirtyColumns.value(rows[i]);
+            const bool adjacent = rows[i] == bottom + 1;
+            const bool overlaps = next.first <= span.second + 1 && next.second >= span.first - 1;
+            if (adjacent && overlaps) {
+                bottom = rows[i];
+                span.first = qMin(span.first, next.first);
+                span.second = qMax(span.second, next.second);
+                continue;
+            }
+
+            emit dataChanged(index(top, span.first), index(bottom, span.second));
+            top = bottom = rows[i];
+            span = next;
+        }
+        emit dataChanged(index(top, span.first), index(bottom, span.second));
+
+        dirtyColumns.clear();
+    }
+
+    // Rebuilds the model inside fill() and reports it as a single reset
+    // instead of one notification per inserted row and item.
+    template <typename Fill>
+    void resetWith(Fill&& fill) {
+        beginResetModel();
+        {
+            const QSignalBlocker blocker(this);
+            fill();
+        }
+        endResetModel();
+    }
+
    private:
+    // Moves dirty rows at or after from by delta. Rows that a removal covered
+    // (from + delta <= row < from) are dropped.
+    void shiftDirtyRows(int from, int delta) {
+        if (dirtyColumns.isEmpty())
+            return;
+
+        QHash<int, QPair<int, int>> shifted;
+        shifted.reserve(dirtyColumns.size());
+        for (auto it = dirtyColumns.cbegin(); it != dirtyColumns.cend(); ++it) {
+            if (it.key() >= from)
+                shifted.insert(it.key() + delta, it.value());
+            else if (delta > 0 || it.key() < from + delta)
+                shifted.insert(it.key(), it.value());
+        }
+        dirtyColumns = std::move(shifted);
+    }
+
     QList<int> editableColumns;
     QList<int> disabledColumns;
+
+    // Row -> first and last column changed by setDataDeferred since the last flush
+    QHash<int, QPair<int, int>> dirtyColumns;
+
+    bool appending = false;
+};
+
+// Read-only handle to one row of the table model. Cheap to copy: values are read
+// from the model when accessed, so nothing is copied up front. A view refers to a
+// model row and is only meaningful until rows are inserted or removed.
+class TABLE_EXPORT RowView {
+   public:
+    RowView() = default;
+    RowView(const QStandardItemModel* model, int row, int viewRow = -1)
+        : model(model), sourceRow(row), proxyRow(viewRow) {}
+
+    bool isValid() const { return model && sourceRow >= 0 && sourceRow < model->rowCount(); }
+
+    // Row in the underlying model (unaffected by sorting and filtering)
+    int row() const { return sourceRow; }
+
+    // Row as displayed when the view was taken, or -1 if it was not taken from the view
+    int viewRow() const { return proxyRow; }
+
+    int columnCount() const { return model ? model->columnCount() : 0; }
+
+    QVariant value(int column, int role = Qt::DisplayRole) const {
+        const QStandardItem* item = model ? model->item(sourceRow, column) : nullptr;
+        return item ? item->data(role) : QVariant();
+    }
+
+    // Typed access. Cells imported with type inference keep their typed value in
+    // ColumnTypes::ValueRole, which is read in place without parsing text.
+    template <typename T>
+    T get(int column) const {
+        const QVariant typed = value(column, ColumnTypes::ValueRole);
+        return (typed.isValid() ? typed : value(column)).value<T>();
+    }
+
+    bool isNull(int column) const { return value(column).isNull(); }
+
+    QString text(int column) const { return value(column).toString(); }
+
+    // Copies the row as text, for APIs that still take a QStringList.
+    QStringList toStringList() const {
+        QStringList values;
+        values.reserve(columnCount());
+        for (int column = 0; column < columnCount(); ++column) {
+            values.append(text(column));
+        }
+        return values;
+    }
+
+   private:
+    const QStandardItemModel* model = nullptr;
+    int sourceRow = -1;
+    int proxyRow = -1;
 };
 
+Q_DECLARE_METATYPE(RowView)
+
 class TABLE_EXPORT TableWidget : public QTableView {
     Q_OBJECT
 
@@ -92,7 +360,7 @@ class TABLE_EXPORT TableWidget : public QTableView {
         : QTableView(parent) {
         tableModel = new CustomTableModel(editableColumns, disabledColumns, this);
 
-        proxyModel = new QSortFilterProxyModel(this);
+        proxyModel = new TableProxyModel(this);
         proxyModel->setSourceModel(tableModel);
         proxyModel->setFilterKeyColumn(-1);
         setModel(proxyModel);
@@ -105,8 +373,44 @@ class TABLE_EXPORT TableWidget : public QTableView {
         connect(selectionModel(), &QItemSelectionModel::selectionChanged, this,
                 &TableWidget::handleSelectionChanged);
 
-        connect(model(), &QAbstractItemModel::dataChanged, this, &TableWidget::handleDataChanged,
-                Qt::QueuedConnection);
+        // Connected to the source model directly, so changed rows are model rows that are
+        // still valid when they are reported.
+        connect(tableModel, &QAbstractItemModel::dataChanged, this, &TableWidget::handleDataChanged);
+
+        ingestTimer = new QTimer(this);
+        connect(ingestTimer, &QTimer::timeout, this, &TableWidget::drainIngest);
+
+        updateFlushTimer = new QTimer(this);
+        updateFlushTimer->setSingleShot(true);
+        updateFlushTimer->setInterval(1000 / 30);
+        connect(updateFlushTimer, &QTimer::timeout, tableModel, &CustomTableModel::flushDirty);
+
+        liveFeedTimer = new QTimer(this);
+        liveFeedTimer->setSingleShot(true);
+        liveFeedTimer->setInterval(16);
+        connect(liveFeedTimer, &QTimer::timeout, this, &TableWidget::drainLiveRows);
+
+        columnFitTimer = new QTimer(this);
+        columnFitTimer->setSingleShot(true);
+        columnFitTimer->setInterval(0);
+        connect(columnFitTimer, &QTimer::timeout, this, &TableWidget::fitColumns);
+        connect(tableModel, &QAbstractItemModel::modelReset, this, [this]() {
+            columnWidths.clear();
+            userSizedColumns.clear();
+            scheduleColumnFit();
+        });
+        // Columns the user drags are left at their width until fit() is called again.
+        connect(horizontalHeader(), &QHeaderView::sectionResized, this, [this](int logicalIndex) {
+            if (!fittingColumns)
+                userSizedColumns.insert(logicalIndex);
+        });
+        connect(tableModel, &QAbstractItemModel::rowsInserted, this, &TableWidget::scheduleColumnFit);
+        connect(tableModel, &QAbstractItemModel::rowsInserted, this,
+                [this](const QModelIndex&, int first, int last) { shiftLongestText(first, last - first + 1); });
+        connect(tableModel, &QAbstractItemModel::rowsRemoved, this,
+                [this](const QModelIndex&, int first, int last) { shiftLongestText(last + 1, first - last - 1); });
+        connect(tableModel, &QAbstractItemModel::columnsInserted, this, &TableWidget::scheduleColumnFit);
+        connect(tableModel, &QAbstractItemModel::dataChanged, this, &TableWidget::fitChangedCells);
 
         contextMenuEnabled = true;
         fit();
@@ -114,6 +418,7 @@ class TABLE_EXPORT TableWidget : public QTableView {
 
     // Destructor
     ~TableWidget() {
+        cancelIngest();
         tableModel->deleteLater();
         proxyModel->deleteLater();
     }
@@ -128,20 +433,28 @@ class TABLE_EXPORT TableWidget : public QTableView {
         return model()->columnCount();
     }
 
-    // Resize headers to fit content
+    // Resize headers to fit content.
+    // Widths come from the header and a sample of rows (the first and last rows, the
+    // visible rows and the longest text seen per column while loading) rather than
+    // from every row. They are cached and only grow when later edits need more room.
     void fit() {
-        // Set horizontal header resize mode to stretch for each column
-        horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+        horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+        autoFitColumns = true;
+        columnWidths.clear();
+        userSizedColumns.clear();
+        scheduleColumnFit();
     }
 
     // Resize headers, stretching them to fill parent
     void stretch() {
         // Set horizontal header resize mode to stretch for each column
+        autoFitColumns = false;
         horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     }
 
     // Set Interactive resizable headers
     void interactive() {
+        autoFitColumns = false;
         horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
     }
 
@@ -165,6 +478,7 @@ class TABLE_EXPORT TableWidget : public QTableView {
         // Set the horizontal Headers
         tableModel->setHorizontalHeaderLabels(horizontalHeaders);
         // Adjust header sizes to fit the contents
+        autoFitColumns = false;
         horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
 
         // Set the field names
@@ -186,7 +500,7 @@ class TABLE_EXPORT TableWidget : public QTableView {
             tableModel->setVerticalHeaderLabels(verticalHeaders);
 
         // Adjust header sizes to fit the contents
-        if (!verticalHeaders.isEmpty())
+        if (!verticalHeaders.isEmpty() && uniformRowHeight == 0)
             verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
     }
 
@@ -197,7 +511,41 @@ class TABLE_EXPORT TableWidget : public QTableView {
 
         if (!verticalHeaders.isEmpty()) {
             tableModel->setVerticalHeaderLabels(verticalHeaders);
-            verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+            if (uniformRowHeight == 0)
+                verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+        }
+    }
+
+    // Gives every row the same fixed height, the style's default if height <= 0.
+    // Row contents and vertical headers are never measured, so scrolling and
+    // scrollToRow() need no per-row sizing.
+    void setUniformRowHeights(bool enabled, int height = 0) {
+        QHeaderView* header = verticalHeader();
+        if (!enabled) {
+            uniformRowHeight = 0;
+            header->setSectionResizeMode(verticalHeaders.isEmpty() ? QHeaderView::Interactive
+                                                                   : QHeaderView::ResizeToContents);
+            return;
+        }
+
+        uniformRowHeight = height > 0 ? height : header->defaultSectionSize();
+        header->setMinimumSectionSize(qMin(header->minimumSectionSize(), uniformRowHeight));
+        header->setDefaultSectionSize(uniformRowHeight);
+        header->setSectionResizeMode(QHeaderView::Fixed);
+    }
+
+    bool hasUniformRowHeights() const {
+        return uniformRowHeight > 0;
+    }
+
+    // Scrolls so that the displayed row is at the top of the view. With uniform row
+    // heights the scroll position is computed directly from the row number.
+    void scrollToRow(int row) {
+        if (uniformRowHeight > 0) {
+            const bool perPixel = verticalScrollMode() == QAbstractItemView::ScrollPerPixel;
+            verticalScrollBar()->setValue(perPixel ? row * uniformRowHeight : row);
+        } else {
+            scrollTo(model()->index(row, 0), QAbstractItemView::PositionAtTop);
         }
     }
 
@@ -205,7 +553,10 @@ class TABLE_EXPORT TableWidget : public QTableView {
      * Populates the table with data.
      */
     void setData(const QVector<QStringList>& data) {
+        cancelIngest();
         tableModel->clear();
+        columnTypes.clear();
+        longestText.clear();
         tableModel->setRowCount(data.size());
         tableModel->setColumnCount(0);
 
@@ -221,208 +572,377 @@ class TABLE_EXPORT TableWidget : public QTableView {
             for (int column = 0; column < rowDataList.size(); ++column) {
                 auto item = new QStandardItem(rowDataList[column]);
                 tableModel->setItem(row, column, item);
+                noteTextLength(row, column, rowDataList[column].size());
             }
         }
     }
 
-    // Sets the signals and slots for double click on table. Calls handler with data for
-    // the double-clicked row.
-    void setDoubleClickHandler(std::function<void(int row, int col, const QStringList& data)> handler) {
-        doubleClickHandler = std::move(handler);
-    }
+    // Replaces the table contents with CSV read from device.
+    // With dialect.hasHeader the first record becomes the field names (and the
+    // headers, if none were set), matching what generateCsvData writes.
+    bool loadCsv(QIODevice* device, const CsvDialect& dialect = CsvDialect()) {
+        if (!device || !device->isReadable())
+            return false;
 
-    // Generates an html table and writes it to a QString that is returned.
-    QString generateHtmlTable() {
-        QString html;
-
-        int rowCount = model()->rowCount();
-        int columnCount = model()->columnCount();
-
-        // Start the HTML table with CSS styles
-        html += "<table style='border-collapse: collapse; width: 100%;'>";
+        const QByteArray bytes = device->readAll();
+        return loadCsvData(bytes.constData(), bytes.constData() + bytes.size(), dialect);
+    }
 
-        // Generate table headers with CSS styles
-        html += "<thead><tr>";
-        for (int col = 0; col < columnCount; ++col) {
-            html += "<th style='border: 1px solid #ddd; padding: 8px; background-color: #f2f2f2;'>";
-            html += model()->headerData(col, Qt::Horizontal).toString();
-            html += "</th>";
+    // Replaces the table contents with a CSV file. The file is memory mapped when possible
+    // and large files are parsed in parallel chunks.
+    bool loadCsv(const QString& path, const CsvDialect& dialect = CsvDialect()) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+
+        const qint64 size = file.size();
+        if (const uchar* mapped = size > 0 ? file.map(0, size) : nullptr) {
+            const char* begin = reinterpret_cast<const char*>(mapped);
+            return loadCsvData(begin, begin + size, dialect);
         }
-        html += "</tr></thead>";
+        return loadCsv(&file, dialect);
+    }
 
-        // Generate table rows with CSS styles
-        html += "<tbody>";
-        for (int row = 0; row < rowCount; ++row) {
-            html += "<tr>";
-            for (int col = 0; col < columnCount; ++col) {
-                html += "<td style='border: 1px solid #ddd; padding: 8px;'>";
-                html += model()->data(model()->index(row, col)).toString();
-                html += "</td>";
-            }
-            html += "</tr>";
+    // Loads a CSV file without blocking the event loop. Parsing runs on a worker thread
+    // and rows are appended in batches for at most 8 ms per event-loop turn, so the table
+    // can be scrolled while it fills. Replaces the current contents; emits ingestProgress
+    // as rows arrive and ingestFinished at the end. Types are inferred from the first batch.
+    bool loadCsvAsync(const QString& path, const CsvDialect& dialect = CsvDialect()) {
+        cancelIngest();
+
+        auto file = std::make_shared<QFile>(path);
+        if (!file->open(QIODevice::ReadOnly))
+            return false;
+
+        const qint64 size = file->size();
+        const uchar* mapped = size > 0 ? file->map(0, size) : nullptr;
+        if (size > 0 && !mapped)
+            return false;
+
+        const char* begin = reinterpret_cast<const char*>(mapped);
+        const char* end = begin + size;
+
+        // The header is tiny; read it here so the columns exist before the first batch.
+        const char* body = begin;
+        QStringList importedFieldNames;
+        if (dialect.hasHeader && size > 0) {
+            body = CsvScanner::nextRecord(begin, end, dialect.quote, false);
+            CsvImportSink header(dialect);
+            parseCsv(begin, body, dialect, header);
+            importedFieldNames = header.fieldNames;
         }
-        html += "</tbody>";
+        setImportedData(ImportColumns(), importedFieldNames, false);
+
+        ingestQueue = std::make_shared<ImportBatchQueue>();
+        ingestTotalBytes = size;
+        ingestRows = 0;
+        ingestInferTypes = dialect.inferTypes;
+
+        ingestFuture = QtConcurrent::run([file, body, end, dialect, queue = ingestQueue]() {
+            readCsvSlices(body, end, dialect, *queue);
+        });
+        ingestTimer->start(0);
+        return true;
+    }
 
-        // End the HTML table
-        html += "</table>";
+    // Stops a running loadCsvAsync. Rows already appended stay in the table. Loading or
+    // clearing the table calls this first, so stale batches never land in new contents.
+    void cancelIngest() {
+        if (!ingestQueue)
+            return;
 
-        return html;
+        ingestQueue->cancel();
+        ingestFuture.waitForFinished();
+        ingestTimer->stop();
+        ingestQueue.reset();
+        ingestBatch = ImportColumns();
+        ingestOffset = 0;
     }
 
-    // Generates and returns QString containing CSV for the table data.
-    QString generateCsvData() {
-        QString csv;
+    bool isIngesting() const { return ingestQueue != nullptr; }
 
-        int rowCount = model()->rowCount();
-        int columnCount = model()->columnCount();
+    // Replaces the table contents with JSON read from device: either an array of objects
+    // as written by generateJsonData, or NDJSON with one object per line. Object keys are
+    // mapped to columns through fieldNames (or the headers); without either, the keys of
+    // the first object become the field names. The input is streamed, never parsed as one document.
+    // With inferTypes, typed values are stored as described for CsvDialect::inferTypes.
+    bool loadJson(QIODevice* device, bool lineDelimited = false, bool inferTypes = false) {
+        if (!device || !device->isReadable())
+            return false;
 
-        if (useFields()) {
-            // Generate CSV headers
-            for (int col = 0; col < columnCount; ++col) {
-                if (col > 0) {
-                    csv += ",";
-                }
-                csv += "\"" + fieldNames[col] + "\"";
-            }
-            csv += "\n";
-        }
+        QStringList keys = useFields() ? fieldNames : headers;
+        const bool derivedKeys = keys.isEmpty();
 
-        // Generate CSV data rows
-        for (int row = 0; row < rowCount; ++row) {
-            for (int col = 0; col < columnCount; ++col) {
-                if (col > 0) {
-                    csv += ",";
-                }
-                QString value = model()->data(model()->index(row, col)).toString();
-                // Quote the value if it contains a comma
-                if (value.contains(',')) {
-                    value = "\"" + value + "\"";
-                }
-                csv += value;
-            }
-            csv += "\n";
-        }
+        JsonRowReader reader(device, lineDelimited);
+        ImportColumns data;
+        if (!readJsonRows(reader, keys, data))
+            return false;
 
-        return csv;
+        setImportedData(data, derivedKeys ? keys : QStringList(), inferTypes);
+        return true;
     }
 
-    // Generates and returns QString containing JSON for the table data.
-    // The valueConverter is required if you want to convert cell data to other types from QString.
-    QString generateJsonData(QVariant (*valueConverter)(int col, const QString& cellData) = nullptr) {
-        QJsonArray rowsArray;
+    // Replaces the table contents with a JSON file. Files ending in .ndjson or .jsonl
+    // are read as one object per line.
+    bool loadJson(const QString& path, bool inferTypes = false) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
 
-        int rowCount = model()->rowCount();
-        int columnCount = model()->columnCount();
+        const QString suffix = QFileInfo(path).suffix().toLower();
+        return loadJson(&file, suffix == "ndjson" || suffix == "jsonl", inferTypes);
+    }
 
-        auto useCustomFields = useFields();
+    // Returns a lightweight accessor for a model row.
+    RowView rowView(int row) const {
+        return RowView(tableModel, row, viewRow(row));
+    }
 
-        // Generate JSON data rows
-        for (int row = 0; row < rowCount; ++row) {
-            QJsonObject rowObject;
-            for (int col = 0; col < columnCount; ++col) {
-                QString columnName = model()->headerData(col, Qt::Horizontal).toString();
+    // Maps a displayed row to its model row. Returns -1 if out of range.
+    int sourceRow(int viewRow) const {
+        return proxyModel->mapToSource(proxyModel->index(viewRow, 0)).row();
+    }
 
-                if (useCustomFields) {
-                    columnName = fieldNames[col];
-                }
+    // Maps a model row to its displayed row. Returns -1 if it is filtered out.
+    int viewRow(int sourceRow) const {
+        return proxyModel->mapFromSource(tableModel->index(sourceRow, 0)).row();
+    }
 
-                QVariant cellValue = model()->data(model()->index(row, col));
-                if (valueConverter) {
-                    // Convert value using the user-provided callback function
-                    cellValue = valueConverter(col, cellValue.toString());
-                }
-                rowObject[columnName] = QJsonValue::fromVariant(cellValue);
-            }
-            rowsArray.append(rowObject);
-        }
+    // Returns the value type inferred for a column by the last import (Text otherwise).
+    ColumnType columnType(int column) const {
+        return columnTypes.value(column, ColumnType::Text);
+    }
 
-        QJsonDocument jsonDoc(rowsArray);
-        return jsonDoc.toJson();
+    // Sets the signals and slots for double click on table. Calls handler with data for
+    // the double-clicked row; row is the displayed row.
+    void setDoubleClickHandler(std::function<void(int row, int col, const QStringList& data)> handler) {
+        doubleClickHandler = std::move(handler);
     }
 
-    void showPrintPreview() {
-        // Generate the HTML table
-        QString htmlTable = generateHtmlTable();
+    // Like setDoubleClickHandler, but passes a RowView so no row data is copied.
+    void setRowDoubleClickHandler(std::function<void(const RowView& row, int col)> handler) {
+        rowDoubleClickHandler = std::move(handler);
+    }
 
-        QString html = "<div style=\"text-align: center; margin-bottom:16px;\">";
+    // Generates an html table and writes it to a QString that is returned.
+    QString generateHtmlTable() {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        writeHtmlTable(&buffer);
+        return QString::fromUtf8(buffer.data());
+    }
 
-        if (!title.isEmpty()) {
-            html += "<h1 style=\"font-size: 18px; margin-bottom: 4px;\">" + title + "</h1>";
+    // Streams the rows [firstRow, firstRow + count) as an html table to device.
+    // A count of -1 writes everything from firstRow on. Rows are read in chunks,
+    // so memory use does not grow with the size of the table.
+    bool writeHtmlTable(QIODevice* device, int firstRow = 0, int count = -1) {
+        const int rowCount = model()->rowCount();
+        const int first = qBound(0, firstRow, rowCount);
+        const int last = count < 0 ? rowCount : qMin(rowCount, first + count);
+
+        HtmlTableWriter writer(device);
+        writer.writeStyleSheet();
+        writer.beginTable(snapshot(0, 0).headers);
+
+        constexpr int chunkRows = 1024;
+        for (int row = first; row < last; row += chunkRows) {
+            const TableSnapshot chunk = snapshot(row, qMin(chunkRows, last - row));
+            for (const QStringList& values : chunk.rows) {
+                writer.writeRow(values);
+            }
         }
 
-        if (!logo.isEmpty()) {
-            html += QString("<div style=\"display: inline-block;\"><img src=\"%1\" width=\"64\" height=\"64\" /></div>").arg(logo.toString());
-        }
+        writer.endTable();
+        return writer.ok();
+    }
+
+    // Generates and returns QString containing CSV for the table data.
+    QString generateCsvData() {
+        return exportToString(ExportFormat::Csv);
+    }
+
+    // Generates and returns QString containing JSON for the table data.
+    // The valueConverter is required if you want to convert cell data to other types from QString.
+    QString generateJsonData(QVariant (*valueConverter)(int col, const QString& cellData) = nullptr) {
+        return exportToString(ExportFormat::Json, valueConverter);
+    }
 
-        html += "<br/> </div>";
-        html += htmlTable;
+    // Writes a snapshot of the table in the given format and returns it as text, so the
+    // in-memory exports quote and encode exactly like exportAsync.
+    QString exportToString(ExportFormat format, TableExporter::ValueConverter valueConverter = nullptr) const {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        TableExporter::write(format, snapshot(), &buffer, TableExporter::Progress(), valueConverter);
+        return QString::fromUtf8(buffer.data());
+    }
 
-        // Create a QTextDocument to set the HTML content
-        QTextDocument document;
-        document.setHtml(html);
+    // Returns a copy of the visible rows (view order) that can be handed to another thread.
+    // firstRow and count select a range of view rows; a count of -1 means all remaining rows.
+    TableSnapshot snapshot(int firstRow = 0, int count = -1) const {
+        TableSnapshot data;
 
-        // Create a custom HTML preview widget
-        HtmlPreviewWidget previewWidget(html);
+        int firstRowIndex = qBound(0, firstRow, proxyModel->rowCount());
+        int rowCount = count < 0 ? proxyModel->rowCount() - firstRowIndex
+                                 : qMin(count, proxyModel->rowCount() - firstRowIndex);
+        int columnCount = proxyModel->columnCount();
 
-        // Create a QPrintPreviewDialog and set the custom preview widget
-        QPrinter printer(QPrinter::HighResolution);
-        QPrintPreviewDialog previewDialog(&printer);
-        previewDialog.setMinimumSize(800, 600);
-        previewDialog.setWindowTitle("Print Preview");
+        data.columns = columnCount;
+        for (int col = 0; col < columnCount; ++col) {
+            data.headers.append(proxyModel->headerData(col, Qt::Horizontal).toString());
+        }
 
-        // Set the custom preview widget as the central widget of the print preview dialog
-        previewDialog.setWindowFlags(previewDialog.windowFlags() &
-                                     ~Qt::WindowContextHelpButtonHint);
+        if (useFields()) {
+            data.fieldNames = fieldNames;
+        }
 
-        QVBoxLayout* layout = new QVBoxLayout();
-        layout->addWidget(&previewWidget);
+        data.rows.reserve(rowCount);
+        for (int row = firstRowIndex; row < firstRowIndex + rowCount; ++row) {
+            const int sourceRow = proxyModel->mapToSource(proxyModel->index(row, 0)).row();
 
-        // Connect the paintRequested signal to handle the printing
-        connect(&previewDialog, &QPrintPreviewDialog::paintRequested, this,
-                [this, &document](QPrinter* printer) { document.print(printer); });
+            QStringList rowData;
+            rowData.reserve(columnCount);
+            for (int col = 0; col < columnCount; ++col) {
+                auto item = tableModel->item(sourceRow, col);
+                rowData.append(item ? item->text() : QString());
+            }
+            data.rows.append(std::move(rowData));
+        }
+        return data;
+    }
 
-        // Show the print preview dialog
-        previewDialog.exec();
+    // Exports the table on a worker thread and returns immediately.
+    // The rows are snapshotted first, so the table stays editable while the export runs.
+    // Progress is reported in rows through the returned future and cancel() stops the
+    // export after the current row. The result is false if writing to device failed.
+    // device must be open and must not be used elsewhere until the future finishes.
+    QFuture<bool> exportAsync(ExportFormat format, QIODevice* device,
+                              TableExporter::ValueConverter valueConverter = nullptr) {
+        return QtConcurrent::run(
+            [format, device, valueConverter](QPromise<bool>& promise, const TableSnapshot& data) {
+                promise.setProgressRange(0, data.rowCount());
+
+                bool ok = TableExporter::write(
+                    format, data, device,
+                    [&promise](int rowsDone) {
+                        promise.setProgressValue(rowsDone);
+                        return !promise.isCanceled();
+                    },
+                    valueConverter);
+
+                promise.addResult(ok);
+            },
+            snapshot());
     }
 
-    void printTable(QPrinter* printer = nullptr) {
-        // Create a QTextBrowser to display the HTML content
-        QTextBrowser textBrowser;
+    // Saves the whole table (all rows, unfiltered) in the native columnar format.
+    // Much faster to reload than CSV or JSON; see tableBinary.h for the layout.
+    bool saveSnapshot(const QString& path, bool checksums = true, QString* errorString = nullptr) const {
+        QStringList headerLabels;
+        for (int col = 0; col < tableModel->columnCount(); ++col) {
+            headerLabels.append(tableModel->headerData(col, Qt::Horizontal).toString());
+        }
 
-        // Generate the HTML table from the QTableView
-        QString htmlTable = generateHtmlTable();
+        return BinaryTableWriter::write(
+            path, headerLabels, fieldNames, tableModel->rowCount(), tableModel->columnCount(),
+            [this](int row, int col) {
+                auto item = tableModel->item(row, col);
+                return item ? item->text() : QString();
+            },
+            checksums, errorString);
+    }
 
-        QString html = "<div style=\"text-align: center; margin-bottom:16px;\">";
+    // Replaces the table contents with a file written by saveSnapshot().
+    // The file is memory mapped and cells are copied into the model with a single reset.
+    bool loadSnapshot(const QString& path, bool verifyChecksums = false, QString* errorString = nullptr) {
+        cancelIngest();
 
-        if (!title.isEmpty()) {
-            html += "<h1 style=\"font-size: 18px; margin-bottom: 4px;\">" + title + "</h1>";
+        BinaryTableReader reader;
+        if (!reader.open(path) || (verifyChecksums && !reader.verifyChecksums())) {
+            if (errorString)
+                *errorString = reader.errorString().isEmpty() ? QString("Checksum mismatch") : reader.errorString();
+            return false;
         }
 
-        if (!logo.isEmpty()) {
-            html += QString("<div style=\"display: inline-block;\"><img src=\"%1\" width=\"64\" height=\"64\" /></div>").arg(logo.toString());
-        }
+        headers = reader.headers();
+        fieldNames = reader.fieldNames();
+
+        const int rows = reader.rowCount();
+        const int columns = reader.columnCount();
+        columnTypes.clear();
+        longestText.clear();
+
+        tableModel->resetWith([&]() {
+            tableModel->setRowCount(0);
+            tableModel->setColumnCount(columns);
+            tableModel->setRowCount(rows);
+            tableModel->setHorizontalHeaderLabels(headers);
+
+            for (int col = 0; col < columns; ++col) {
+                reader.forEachCell(col, [this, col](int row, const QString& text) {
+                    tableModel->setItem(row, col, new QStandardItem(text));
+                    noteTextLength(row, col, text.size());
+                });
+            }
+        });
+        return true;
+    }
+
+    // Returns a print engine for the visible rows, with the table title and logo.
+    TablePrintEngine printEngine() const {
+        return TablePrintEngine(snapshot(), title, logo);
+    }
 
-        html += "<br/> </div>";
-        html += htmlTable;
+    // Writes the visible rows straight to a PDF file with the native table painter.
+    // Pages are streamed to the file as they are painted, one at a time.
+    bool exportPdf(const QString& path, const PdfExportOptions& options = PdfExportOptions()) const {
+        QPdfWriter writer(path);
+        writer.setResolution(options.resolution);
+        writer.setPageLayout(QPageLayout(options.pageSize, options.orientation, options.margins,
+                                         QPageLayout::Millimeter));
+        writer.setTitle(options.title.isEmpty() ? title : options.title);
+        writer.setCreator(QApplication::applicationName());
+
+        TablePrintEngine engine = printEngine();
+        return engine.print(&writer);
+    }
 
-        // Set the HTML content to the QTextBrowser
-        textBrowser.setHtml(html);
+    // Shows a preview that lays the pages out in the background and renders
+    // only the pages scrolled into view.
+    void showPrintPreview() {
+        TablePrintPreviewDialog previewDialog(printEngine(), this);
+        previewDialog.exec();
+    }
 
+    void printTable(QPrinter* printer = nullptr) {
+        std::unique_ptr<QPrinter> defaultPrinter;
         if (printer == nullptr) {
-            printer = new QPrinter(QPrinter::HighResolution);
+            defaultPrinter = std::make_unique<QPrinter>(QPrinter::HighResolution);
+            printer = defaultPrinter.get();
         }
 
-        // Print the QTextBrowser content
         QPrintDialog printDialog(printer);
         if (printDialog.exec() == QDialog::Accepted) {
-            textBrowser.print(printer);
+            TablePrintEngine engine = printEngine();
+            engine.print(printer);
         }
     }
 
     void appendRow(const QStringList& rowData) {
-        int row = tableModel->rowCount();
-        tableModel->setRowCount(row + 1);
-        setRowData(row, rowData);
+        appendRowBatch(QVector<QStringList>{rowData});
+    }
+
+    // Thread-safe, non-blocking append for live feeds. Rows are queued lock-free and the
+    // GUI thread appends everything pushed during a frame (~16 ms) as one batch, so
+    // producers never wait and the view sees one insertion per frame.
+    void pushRows(QVector<QStringList> rows) {
+        if (rows.isEmpty())
+            return;
+
+        liveRows.push(std::move(rows));
+        if (!liveDrainScheduled.exchange(true, std::memory_order_acq_rel)) {
+            QMetaObject::invokeMethod(
+                this, [this]() { liveFeedTimer->start(); }, Qt::QueuedConnection);
+        }
     }
 
     void deleteRow(int row) {
@@ -431,21 +951,42 @@ class TABLE_EXPORT TableWidget : public QTableView {
         }
     }
 
-    void clearTable() { tableModel->clear(); }
+    void clearTable() {
+        cancelIngest();
+        tableModel->clear();
+        columnTypes.clear();
+        longestText.clear();
+    }
 
     void appendRows(const QVector<QStringList>& rowsData) {
-        int currentRowCount = tableModel->rowCount();
-        int rowsToAdd = rowsData.size();
-        int newRowCount = currentRowCount + rowsToAdd;
+        appendRowBatch(rowsData);
+    }
 
-        tableModel->setRowCount(newRowCount);
+    // Updates one cell (model row and column) for high-frequency feeds. The value is
+    // stored immediately, but views are told about it at most maxUpdateRate times per
+    // second, with one dataChanged per merged dirty region.
+    void setCellValue(int row, int column, const QVariant& value) {
+        tableModel->setDataDeferred(tableModel->index(row, column), value);
+        if (tableModel->hasDirtyCells() && !updateFlushTimer->isActive())
+            updateFlushTimer->start();
+    }
 
-        for (int row = 0; row < rowsToAdd; ++row) {
-            const QStringList& rowData = rowsData[row];
-            setRowData(currentRowCount + row, rowData);
-        }
+    // Maximum number of change notifications per second from setCellValue. Default 30.
+    void setMaxUpdateRate(int hz) {
+        updateFlushTimer->setInterval(1000 / qBound(1, hz, 1000));
+    }
+
+    // Keeps only the newest capacity rows, like a tail -f log. Appends beyond the
+    // capacity drop the oldest rows; each batch reaches the view as at most one
+    // removal and one insertion. 0 (the default) means unbounded.
+    void setRingCapacity(int capacity) {
+        ringCapacityLimit = qMax(0, capacity);
+        if (ringCapacityLimit > 0 && tableModel->rowCount() > ringCapacityLimit)
+            tableModel->removeRows(0, tableModel->rowCount() - ringCapacityLimit);
     }
 
+    int ringCapacity() const { return ringCapacityLimit; }
+
     auto getAllTableData() const {
         QList<QList<QVariant>> tableData;
 
@@ -467,37 +1008,158 @@ class TABLE_EXPORT TableWidget : public QTableView {
     QList<QList<QString>> getSelectedRows() const {
         QList<QList<QString>> selectedRowsData;
 
-        QModelIndexList selectedIndexes = selectionModel()->selectedRows();
-        for (const QModelIndex& index : selectedIndexes) {
-            QList<QString> rowData;
+        selectedRowsData.reserve(selectedRowCount());
+        forEachSelectedRow([&](const RowView& row) { selectedRowsData.append(row.toStringList()); });
+
+        return selectedRowsData;
+    }
+
+    // Selected rows in view order, without copying their data.
+    QList<RowView> selectedRowViews() const {
+        QList<RowView> rows;
+
+        rows.reserve(selectedRowCount());
+        forEachSelectedRow([&](const RowView& row) { rows.append(row); });
+        return rows;
+    }
 
-            for (int col = 0; col < tableModel->columnCount(); ++col) {
-                QModelIndex dataIndex = tableModel->index(index.row(), col);
-                QString data = tableModel->data(dataIndex).toString();
-                rowData.append(data);
+    // Calls fn(const RowView&) for each selected row in view order. Nothing is
+    // collected, so this is the way to walk very large selections.
+    template <typename Fn>
+    void forEachSelectedRow(Fn&& fn) const {
+        for (const QPair<int, int>& range : selectedRowRanges()) {
+            for (int row = range.first; row <= range.second; ++row) {
+                fn(rowViewAt(model()->index(row, 0)));
             }
-            selectedRowsData.append(rowData);
         }
+    }
 
-        return selectedRowsData;
+    int selectedRowCount() const {
+        int count = 0;
+        for (const QPair<int, int>& range : selectedRowRanges()) {
+            count += range.second - range.first + 1;
+        }
+        return count;
     }
 
-    std::optional<QStringList> getCurrentRow() const {
-        std::optional<QStringList> rowData;
+    // The selection as sorted, non-overlapping [first, last] intervals of displayed
+    // rows. Costs O(ranges), however many rows they cover.
+    QList<QPair<int, int>> selectedRowRanges() const {
+        QList<QPair<int, int>> ranges;
 
-        QModelIndex index = currentIndex();
-        if (index.isValid()) {
-            rowData.emplace();
+        const QItemSelection selection = selectionModel()->selection();
+        ranges.reserve(selection.size());
+        for (const QItemSelectionRange& range : selection) {
+            ranges.append({range.top(), range.bottom()});
+        }
+        return mergeRowRanges(std::move(ranges));
+    }
+
+    // Replaces the selection with whole rows from [first, last] intervals of
+    // displayed rows, emitting a single selectionChanged.
+    void selectRowRanges(const QList<QPair<int, int>>& ranges) {
+        const int lastRow = model()->rowCount() - 1;
+        const int lastColumn = model()->columnCount() - 1;
+
+        QItemSelection selection;
+        for (const QPair<int, int>& range : mergeRowRanges(ranges)) {
+            const int first = qMax(range.first, 0);
+            const int last = qMin(range.second, lastRow);
+            if (first <= last && lastColumn >= 0) {
+                selection.append(
+                    QItemSelectionRange(model()->index(first, 0), model()->index(last, lastColumn)));
+            }
+        }
+        selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect);
+    }
+
+    // Selects every row as one range, regardless of the selection mode.
+    void selectAllRows() {
+        selectRowRanges({{0, model()->rowCount() - 1}});
+    }
+
+    // Selects exactly the rows that are not selected.
+    void invertSelection() {
+        QList<QPair<int, int>> inverted;
+
+        int next = 0;
+        for (const QPair<int, int>& range : selectedRowRanges()) {
+            if (range.first > next)
+                inverted.append({next, range.first - 1});
+            next = range.second + 1;
+        }
+        if (next < model()->rowCount())
+            inverted.append({next, model()->rowCount() - 1});
+
+        selectRowRanges(inverted);
+    }
+
+    // Selects the displayed rows for which predicate(const RowView&) is true. Runs of
+    // matching rows become single ranges, applied in one notification.
+    void selectRowsWhere(const std::function<bool(const RowView&)>& predicate) {
+        QList<QPair<int, int>> ranges;
+
+        for (int row = 0; row < model()->rowCount(); ++row) {
+            if (predicate(rowViewAt(model()->index(row, 0))))
+                addToRanges(ranges, row);
+        }
+        selectRowRanges(ranges);
+    }
+
+    // Selects the displayed rows whose value in column satisfies predicate. Cells are passed
+    // as their typed value (ColumnTypes::ValueRole) when they have one, otherwise as their
+    // text. The column is evaluated in parallel straight from the model, and the matches
+    // are applied as merged ranges in one select call, so 100k matching rows are one
+    // notification. predicate runs on worker threads and must not touch widgets.
+    void selectWhere(int column, const std::function<bool(const QVariant& value)>& predicate) {
+        if (column < 0 || column >= tableModel->columnCount())
+            return;
+
+        selectMatchedRows(matchModelRows([&](int row) {
+            const QStandardItem* item = tableModel->item(row, column);
+            if (!item)
+                return predicate(QVariant());
+            const QVariant typed = item->data(ColumnTypes::ValueRole);
+            return predicate(typed.isValid() ? typed : item->data(Qt::DisplayRole));
+        }));
+    }
+
+    // Selects the displayed rows where expression matches the text of column, or of any
+    // column when column is -1, like filterTable(). Evaluated in parallel.
+    void selectWhere(const QRegularExpression& expression, int column = -1) {
+        if (!expression.isValid() || column < -1 || column >= tableModel->columnCount())
+            return;
 
-            for (int col = 0; col < tableModel->columnCount(); ++col) {
-                QModelIndex dataIndex = tableModel->index(index.row(), col);
-                QVariant data = tableModel->data(dataIndex);
-                rowData->append(data.toString());
+        const int firstColumn = column < 0 ? 0 : column;
+        const int lastColumn = column < 0 ? tableModel->columnCount() - 1 : column;
+        expression.optimize();
+
+        selectMatchedRows(matchModelRows([&](int row) {
+            for (int col = firstColumn; col <= lastColumn; ++col) {
+                const QStandardItem* item = tableModel->item(row, col);
+                if (item && expression.match(item->text()).hasMatch())
+                    return true;
             }
+            return false;
+        }));
+    }
+
+    std::optional<QStringList> getCurrentRow() const {
+        std::optional<QStringList> rowData;
+
+        const RowView row = currentRowView();
+        if (row.isValid()) {
+            rowData = row.toStringList();
         }
         return rowData;
     }
 
+    // The row holding the current index, or an invalid view if there is none.
+    RowView currentRowView() const {
+        const QModelIndex index = currentIndex();
+        return index.isValid() ? rowViewAt(index) : RowView();
+    }
+
     void selectRowRange(int startRow, int endRow) {
         // Create the selection model and get the model index for the desired row
         QItemSelectionModel* selModel = selectionModel();
@@ -532,16 +1194,11 @@ class TABLE_EXPORT TableWidget : public QTableView {
     void mouseDoubleClickEvent(QMouseEvent* event) override {
         QModelIndex index = indexAt(event->pos());
         if (index.isValid()) {
-            int row = index.row();
-            int column = index.column();
-
-            QStringList rowData;
-            for (int c = 0; c < tableModel->columnCount(); ++c) {
-                auto cellItem = tableModel->item(row, c);
-                if (cellItem)
-                    rowData.append(cellItem->text());
-            }
-            doubleClickHandler(row, column, rowData);
+            const RowView row = rowViewAt(index);
+            if (rowDoubleClickHandler)
+                rowDoubleClickHandler(row, index.column());
+            if (doubleClickHandler)
+                doubleClickHandler(index.row(), index.column(), row.toStringList());
         }
 
         // Call base class implementation
@@ -584,7 +1241,7 @@ class TABLE_EXPORT TableWidget : public QTableView {
         } else if (selectedItem == deleteAction) {
             QModelIndex index = currentIndex();
             if (index.isValid()) {
-                deleteRow(index.row());
+                deleteRow(sourceRow(index.row()));
             }
         }
 
@@ -592,8 +1249,18 @@ class TABLE_EXPORT TableWidget : public QTableView {
     }
 
    signals:
+    // In tableSelectionChanged and rowUpdated, row is the displayed row and rowData
+    // comes from the matching model row; use sourceRow() to map it.
     void tableSelectionChanged(int row, int column, const QStringList& rowData);
+    // Emitted with the first newly selected row; reads nothing until asked.
+    // row.row() is the model row and row.viewRow() the displayed one.
+    void rowSelected(const RowView& row, int column);
     void rowUpdated(int row, int column, const QStringList& rowData);
+    // Model rows whose data changed, in one notification per change batch.
+    // Read them with rowView().
+    void rowsUpdated(const QList<int>& rows);
+    void ingestProgress(int rowsLoaded, qint64 bytesRead, qint64 totalBytes);
+    void ingestFinished(bool ok);
 
    public slots:
     void filterTable(const QString& query,
@@ -619,52 +1286,394 @@ class TABLE_EXPORT TableWidget : public QTableView {
         if (selected.isEmpty())
             return;
 
-        int selectedRow = selected.indexes().first().row();
-        int selectedCol = selected.indexes().first().column();
+        // The top-left of the first range; indexes() would list every selected cell.
+        const QModelIndex first = selected.first().topLeft();
+        const RowView row = rowViewAt(first);
+        emit rowSelected(row, first.column());
 
-        QStringList rowData;
-        for (int column = 0; column < tableModel->columnCount(); ++column) {
-            auto item = tableModel->item(selectedRow, column);
-            if (item)
-                rowData.append(item->text());
+        static const QMetaMethod selectionSignal = QMetaMethod::fromSignal(&TableWidget::tableSelectionChanged);
+        if (isSignalConnected(selectionSignal)) {
+            emit tableSelectionChanged(first.row(), first.column(), row.toStringList());
         }
-        emit tableSelectionChanged(selectedRow, selectedCol, rowData);
     }
 
     void handleDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
                            const QVector<int>& roles = QVector<int>()) {
         Q_UNUSED(roles);
 
-        // If no row selected, we are just setting the data
-        if (selectionModel()->selectedIndexes().isEmpty())
+        // Newly appended rows are not edits. If no row selected, we are just setting the data
+        if (tableModel->isAppending() || !selectionModel()->hasSelection())
             return;
 
-        if (topLeft.row() != bottomRight.row()) {
-            // Only handle single-row changes
+        const int lastRow = qMin(bottomRight.row(), tableModel->rowCount() - 1);
+        QList<int> rows;
+        for (int row = qMax(topLeft.row(), 0); row <= lastRow; ++row) {
+            rows.append(row);
+        }
+        if (rows.isEmpty())
             return;
+        emit rowsUpdated(rows);
+
+        // The per-row signal copies the whole row, so only build it for listeners.
+        static const QMetaMethod rowUpdatedSignal = QMetaMethod::fromSignal(&TableWidget::rowUpdated);
+        if (rows.size() == 1 && isSignalConnected(rowUpdatedSignal)) {
+            const int displayedRow = viewRow(rows.first());
+            if (displayedRow >= 0)
+                emit rowUpdated(displayedRow, topLeft.column(), rowView(rows.first()).toStringList());
         }
+    }
 
-        QStringList rowData;
-        const int row = topLeft.row();
+    // Sizes columns from the header and a sample of rows; see fit().
+    void fitColumns() {
+        if (!autoFitColumns)
+            return;
 
-        for (int column = 0; column < tableModel->columnCount(); ++column) {
-            QModelIndex index = tableModel->index(row, column);
-            QVariant data = tableModel->data(index);
-            QString cellData = data.toString();
-            rowData.append(cellData);
+        const int rows = model()->rowCount();
+        QVector<int> sample;
+        for (int row = 0; row < qMin(rows, fitSampleRows); ++row) {
+            sample.append(row);
+        }
+        for (int row = qMax(fitSampleRows, rows - fitSampleRows); row < rows; ++row) {
+            sample.append(row);
+        }
+        const int firstVisible = rowAt(0);
+        if (firstVisible >= 0) {
+            const int lastVisible = rowAt(viewport()->height() - 1);
+            const int last = lastVisible >= 0 ? lastVisible : qMin(rows - 1, firstVisible + fitSampleRows);
+            for (int row = firstVisible; row <= last; ++row) {
+                sample.append(row);
+            }
+        }
+
+        // After fit() or a reset the columns are sized from scratch and may shrink.
+        const bool refit = columnWidths.isEmpty();
+        columnWidths.resize(model()->columnCount());
+        for (int col = 0; col < model()->columnCount(); ++col) {
+            int width = horizontalHeader()->sectionSizeHint(col);
+            for (int row : std::as_const(sample)) {
+                width = qMax(width, measureCell(model()->index(row, col)));
+            }
+            if (col < longestText.size() && longestText[col].first >= 0) {
+                const int row = viewRow(longestText[col].first);
+                if (row >= 0)
+                    width = qMax(width, measureCell(model()->index(row, col)));
+            }
+
+            columnWidths[col] = qMax(columnWidths[col], width);
+            sizeFittedColumn(col, columnWidths[col], refit);
+        }
+    }
+
+    // Widens columns whose edited cells no longer fit. Large changes are left to a
+    // sampled refit instead of measuring every changed cell.
+    void fitChangedCells(const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+        if (!autoFitColumns)
+            return;
+
+        if (bottomRight.row() - topLeft.row() >= fitSampleRows) {
+            scheduleColumnFit();
+            return;
+        }
+
+        for (int col = topLeft.column(); col <= bottomRight.column() && col < columnWidths.size(); ++col) {
+            for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+                const QModelIndex index = proxyModel->mapFromSource(tableModel->index(row, col));
+                if (!index.isValid())
+                    continue;
+
+                const int width = measureCell(index);
+                if (width > columnWidths[col]) {
+                    columnWidths[col] = width;
+                    sizeFittedColumn(col, width);
+                }
+            }
+        }
+    }
+
+    // Appends everything pushed through pushRows() since the last frame.
+    void drainLiveRows() {
+        // Reset first so a push racing with the drain schedules another frame. The
+        // acquire half pairs with the producer's exchange, so pushes made before it are seen.
+        liveDrainScheduled.exchange(false, std::memory_order_acq_rel);
+
+        QVector<QStringList> rows;
+        QVector<QStringList> batch;
+        while (liveRows.pop(batch)) {
+            rows.append(std::move(batch));
+        }
+        appendRowBatch(rows);
+    }
+
+    // Appends parsed rows from the ingest queue until the time slice is used up.
+    void drainIngest() {
+        if (!ingestQueue)
+            return;
+
+        QElapsedTimer slice;
+        slice.start();
+
+        bool appended = false;
+        while (slice.elapsed() < ingestSliceMs) {
+            if (ingestOffset >= ingestBatch.rowCount()) {
+                if (!ingestQueue->tryPop(ingestBatch))
+                    break;
+
+                ingestOffset = 0;
+                if (ingestInferTypes) {
+                    columnTypes.fill(ColumnType::Text, ingestBatch.columnCount());
+                    for (int col = 0; col < ingestBatch.columnCount(); ++col) {
+                        columnTypes[col] = ColumnTypes::infer(ingestBatch.columns[col]);
+                    }
+                    ingestInferTypes = false;
+                }
+            }
+
+            // Blocks hold a fixed number of cells, so wide tables stay within the slice too
+            const int chunkRows = qMax(1, ingestChunkCells / qMax(1, ingestBatch.columnCount()));
+            const int count = qMin(chunkRows, ingestBatch.rowCount() - ingestOffset);
+            appendImportedRows(ingestBatch, ingestOffset, count);
+            ingestOffset += count;
+            ingestRows += count;
+            appended = true;
+        }
+
+        // Poll gently while the worker is still parsing the next slice
+        ingestTimer->setInterval(appended ? 0 : 10);
+
+        emit ingestProgress(ingestRows, ingestQueue->bytesDone(), ingestTotalBytes);
+
+        if (ingestOffset >= ingestBatch.rowCount() && ingestQueue->isDone()) {
+            const bool ok = ingestQueue->errorString().isEmpty();
+            ingestTimer->stop();
+            ingestQueue.reset();
+            ingestBatch = ImportColumns();
+            ingestOffset = 0;
+            emit ingestFinished(ok);
         }
-        emit rowUpdated(row, topLeft.column(), rowData);
-        return QTableView::dataChanged(topLeft, bottomRight, roles);
     }
 
    private:
     std::function<void(int, int, const QStringList&)> doubleClickHandler;
+    std::function<void(const RowView&, int)> rowDoubleClickHandler;
+
+    // Adds row to ascending [first, last] intervals, extending the last one if adjacent.
+    static void addToRanges(QList<QPair<int, int>>& ranges, int row) {
+        if (!ranges.isEmpty() && ranges.last().second == row - 1)
+            ranges.last().second = row;
+        else
+            ranges.append({row, row});
+    }
+
+    // Evaluates matches(modelRow) for every model row on the thread pool, in blocks.
+    // The model is only read, and the GUI thread waits, so nothing can change it meanwhile.
+    template <typename Fn>
+    QVector<char> matchModelRows(const Fn& matches) const {
+        constexpr int BlockRows = 4096;
+        const int rowCount = tableModel->rowCount();
+
+        QVector<char> matched(rowCount, 0);
+        char* out = matched.data();
+
+        QVector<int> blocks;
+        for (int first = 0; first < rowCount; first += BlockRows) {
+            blocks.append(first);
+        }
+        QtConcurrent::blockingMap(blocks, [&](int& first) {
+            const int end = qMin(first + BlockRows, rowCount);
+            for (int row = first; row < end; ++row) {
+                out[row] = matches(row);
+            }
+        });
+        return matched;
+    }
+
+    // Selects the displayed rows whose model row is flagged in matched.
+    void selectMatchedRows(const QVector<char>& matched) {
+        QList<QPair<int, int>> ranges;
+
+        for (int row = 0; row < model()->rowCount(); ++row) {
+            if (matched.value(sourceRow(row)))
+                addToRanges(ranges, row);
+        }
+        selectRowRanges(ranges);
+    }
+
+    // Sorts [first, last] intervals and merges overlapping or adjacent ones.
+    static QList<QPair<int, int>> mergeRowRanges(QList<QPair<int, int>> ranges) {
+        std::sort(ranges.begin(), ranges.end());
+
+        QList<QPair<int, int>> merged;
+        for (const QPair<int, int>& range : std::as_const(ranges)) {
+            if (!merged.isEmpty() && range.first <= merged.last().second + 1)
+                merged.last().second = qMax(merged.last().second, range.second);
+            else
+                merged.append(range);
+        }
+        return merged;
+    }
+
+    // RowView for an index of the view, i.e. of the proxy model.
+    RowView rowViewAt(const QModelIndex& viewIndex) const {
+        return RowView(tableModel, proxyModel->mapToSource(viewIndex).row(), viewIndex.row());
+    }
+
     void setRowData(int row, const QStringList& rowData) {
         for (int column = 0; column < tableModel->columnCount(); ++column) {
             QStandardItem* item = new QStandardItem();
             item->setText(rowData.value(column));
             tableModel->setItem(row, column, item);
+            noteTextLength(row, column, item->text().size());
+        }
+    }
+
+    // Remembers the longest text per column as a sample candidate for fitColumns().
+    void noteTextLength(int row, int column, int length) {
+        if (longestText.size() <= column)
+            longestText.resize(column + 1, {-1, -1});
+        if (length > longestText[column].second)
+            longestText[column] = {row, length};
+    }
+
+    // Keeps the longest-text rows on their cells when rows are inserted or removed.
+    // A removed candidate is forgotten so the next long cell replaces it.
+    void shiftLongestText(int from, int delta) {
+        for (QPair<int, int>& candidate : longestText) {
+            if (candidate.first >= from)
+                candidate.first += delta;
+            else if (delta < 0 && candidate.first >= from + delta)
+                candidate = {-1, -1};
+        }
+    }
+
+    // Grows a fitted column to width; with refit it may also shrink. User-sized columns are left alone.
+    void sizeFittedColumn(int col, int width, bool refit = false) {
+        if (userSizedColumns.contains(col) || width == horizontalHeader()->sectionSize(col))
+            return;
+        if (!refit && width < horizontalHeader()->sectionSize(col))
+            return;
+
+        fittingColumns = true;
+        horizontalHeader()->resizeSection(col, width);
+        fittingColumns = false;
+    }
+
+    void scheduleColumnFit() {
+        if (autoFitColumns && !columnFitTimer->isActive())
+            columnFitTimer->start();
+    }
+
+    // Preferred width of a cell of the view, as the delegate would draw it.
+    int measureCell(const QModelIndex& index) const {
+        QStyleOptionViewItem option;
+        initViewItemOption(&option);
+        return itemDelegateForIndex(index)->sizeHint(option, index).width() + (showGrid() ? 1 : 0);
+    }
+
+    bool loadCsvData(const char* begin, const char* end, const CsvDialect& dialect) {
+        QStringList importedFieldNames;
+        const ImportColumns data = parseCsvParallel(begin, end, dialect, &importedFieldNames);
+        setImportedData(data, importedFieldNames, dialect.inferTypes);
+        return true;
+    }
+
+    // Copies an import buffer into the model with a single reset.
+    // With inferTypes, each column's type is inferred from a sample and cells that parse
+    // as that type also get their typed value in ColumnTypes::ValueRole.
+    void setImportedData(const ImportColumns& data, const QStringList& importedFieldNames, bool inferTypes) {
+        cancelIngest();
+
+        if (!importedFieldNames.isEmpty()) {
+            fieldNames = importedFieldNames;
+            if (headers.size() != fieldNames.size())
+                headers = fieldNames;
+        }
+
+        const int rows = data.rowCount();
+        const int columns = qMax(data.columnCount(), importedFieldNames.size());
+
+        longestText.clear();
+        columnTypes.fill(ColumnType::Text, columns);
+        if (inferTypes) {
+            for (int col = 0; col < data.columnCount(); ++col) {
+                columnTypes[col] = ColumnTypes::infer(data.columns[col]);
+            }
+        }
+
+        tableModel->resetWith([&]() {
+            tableModel->setRowCount(0);
+            tableModel->setColumnCount(columns);
+            tableModel->setRowCount(rows);
+            tableModel->setHorizontalHeaderLabels(headers);
+
+            for (int col = 0; col < data.columnCount(); ++col) {
+                const QStringList& values = data.columns[col];
+                const ColumnType type = columnTypes[col];
+                for (int row = 0; row < rows; ++row) {
+                    tableModel->setItem(row, col, importedItem(values[row], type));
+                    noteTextLength(row, col, values[row].size());
+                }
+            }
+        });
+    }
+
+    // Appends rows with one insert notification. With a ring capacity, the oldest rows
+    // are dropped first in a single removal, and only the newest rows of an oversized
+    // batch are kept.
+    void appendRowBatch(const QVector<QStringList>& rowsData) {
+        int first = 0;
+        int count = rowsData.size();
+
+        if (ringCapacityLimit > 0) {
+            if (count > ringCapacityLimit) {
+                first = count - ringCapacityLimit;
+                count = ringCapacityLimit;
+            }
+
+            const int overflow = tableModel->rowCount() + count - ringCapacityLimit;
+            if (overflow > 0)
+                tableModel->removeRows(0, overflow);
         }
+
+        if (count == 0)
+            return;
+
+        tableModel->appendRowsWith(count, [&](int firstRow) {
+            for (int row = 0; row < count; ++row) {
+                setRowData(firstRow + row, rowsData[first + row]);
+            }
+        });
+    }
+
+    // Appends rows [first, first + count) of an import buffer with one insert notification.
+    void appendImportedRows(const ImportColumns& data, int first, int count) {
+        if (count <= 0)
+            return;
+
+        if (tableModel->columnCount() < data.columnCount())
+            tableModel->setColumnCount(data.columnCount());
+        if (columnTypes.size() < tableModel->columnCount())
+            columnTypes.resize(tableModel->columnCount());
+
+        tableModel->appendRowsWith(count, [&](int firstRow) {
+            for (int col = 0; col < data.columnCount(); ++col) {
+                const QStringList& values = data.columns[col];
+                const ColumnType type = columnTypes[col];
+                for (int row = 0; row < count; ++row) {
+                    tableModel->setItem(firstRow + row, col, importedItem(values[first + row], type));
+                    noteTextLength(firstRow + row, col, values[first + row].size());
+                }
+            }
+        });
+    }
+
+    static QStandardItem* importedItem(const QString& text, ColumnType type) {
+        QStandardItem* item = new QStandardItem(text);
+        if (type != ColumnType::Text && !ColumnTypes::isNull(text)) {
+            const QVariant value = ColumnTypes::convert(text, type);
+            if (value.isValid())
+                item->setData(value, ColumnTypes::ValueRole);
+        }
+        return item;
     }
 
     bool contextMenuEnabled;
@@ -685,6 +1694,44 @@ class TABLE_EXPORT TableWidget : public QTableView {
     // Vertical Headers
     QStringList verticalHeaders;
 
+    // Value type of each column, as inferred by the last import
+    QVector<ColumnType> columnTypes;
+
+    // Background ingestion state (loadCsvAsync)
+    static constexpr int ingestSliceMs = 8;
+    static constexpr int ingestChunkCells = 16384;
+    QTimer* ingestTimer;
+    std::shared_ptr<ImportBatchQueue> ingestQueue;
+    QFuture<void> ingestFuture;
+    ImportColumns ingestBatch;
+    int ingestOffset = 0;
+    int ingestRows = 0;
+    qint64 ingestTotalBytes = 0;
+    bool ingestInferTypes = false;
+
+    // Maximum number of rows kept by appends; 0 is unbounded
+    int ringCapacityLimit = 0;
+
+    // Throttles setCellValue notifications
+    QTimer* updateFlushTimer;
+
+    // Live feed state (pushRows)
+    QTimer* liveFeedTimer;
+    MpscQueue<QVector<QStringList>> liveRows;
+    std::atomic<bool> liveDrainScheduled{false};
+
+    // Fixed height of every row, or 0 when rows are sized individually
+    int uniformRowHeight = 0;
+
+    // Sampled column sizing (fit)
+    static constexpr int fitSampleRows = 32;
+    bool autoFitColumns = false;
+    QTimer* columnFitTimer;
+    QVector<int> columnWidths;
+    QSet<int> userSizedColumns;  // Logical columns resized by the user since the last fit()
+    bool fittingColumns = false;
+    QVector<QPair<int, int>> longestText;  // Per column: model row and length of the longest text
+
     // use fieldNames in generating csv and json
     bool useFields() const {
         return (headers.size() == fieldNames.size()) && (fieldNames.size() == model()->columnCount());